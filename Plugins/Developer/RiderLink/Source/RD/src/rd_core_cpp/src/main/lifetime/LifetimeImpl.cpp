@@ -1,14 +1,113 @@
 #include "LifetimeImpl.h"
 
+#include <algorithm>
+#include <thread>
 #include <utility>
 
 namespace rd
 {
-#if __cplusplus < 201703L
-LifetimeImpl::counter_t LifetimeImpl::get_id = 0;
-#endif
+std::atomic<LifetimeImpl::counter_t> LifetimeImpl::get_id{0};
 
-LifetimeImpl::LifetimeImpl(bool is_eternal) : eternaled(is_eternal), id(LifetimeImpl::get_id++)
+// region SpinLock
+
+void LifetimeImpl::SpinLock::lock()
+{
+	for (int spins = 0; flag.test_and_set(std::memory_order_acquire); ++spins)
+	{
+		if (spins >= 64)
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+// endregion
+
+// region Slots
+
+constexpr size_t LifetimeImpl::Slots::INLINE_CAPACITY;
+
+LifetimeImpl::Slots::Slots(Slots&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+LifetimeImpl::Slots& LifetimeImpl::Slots::operator=(Slots&& other) noexcept
+{
+	if (this == &other)
+	{
+		return *this;
+	}
+
+	clear();
+	if (other.is_spilled)
+	{
+		spilled = std::move(other.spilled);
+		other.spilled.clear();
+	}
+	else
+	{
+		for (size_t i = 0; i < other.count; ++i)
+		{
+			inline_slots[i] = std::move(other.inline_slots[i]);
+			other.inline_slots[i] = Slot{};
+		}
+	}
+	is_spilled = other.is_spilled;
+	count = other.count;
+	other.is_spilled = false;
+	other.count = 0;
+	return *this;
+}
+
+LifetimeImpl::Slot* LifetimeImpl::Slots::find(counter_t id)
+{
+	Slot* it = std::lower_bound(begin(), end(), id, [](Slot const& slot, counter_t value) { return slot.id < value; });
+	return it != end() && it->id == id ? it : nullptr;
+}
+
+void LifetimeImpl::Slots::push_back(Slot slot)
+{
+	if (!is_spilled)
+	{
+		if (count < INLINE_CAPACITY)
+		{
+			inline_slots[count++] = std::move(slot);
+			return;
+		}
+		spilled.reserve(2 * INLINE_CAPACITY);
+		for (size_t i = 0; i < count; ++i)
+		{
+			spilled.push_back(std::move(inline_slots[i]));
+			inline_slots[i] = Slot{};
+		}
+		is_spilled = true;
+	}
+	spilled.push_back(std::move(slot));
+	++count;
+}
+
+void LifetimeImpl::Slots::resize_down(size_t new_count)
+{
+	if (is_spilled)
+	{
+		spilled.resize(new_count);
+		// capacity is kept for the next spill
+		is_spilled = new_count > 0;
+	}
+	else
+	{
+		for (size_t i = new_count; i < count; ++i)
+		{
+			inline_slots[i] = Slot{};
+		}
+	}
+	count = new_count;
+}
+
+// endregion
+
+LifetimeImpl::LifetimeImpl(bool is_eternal) : eternaled(is_eternal), id(LifetimeImpl::get_id.fetch_add(1, std::memory_order_relaxed))
 {
 }
 
@@ -17,22 +116,99 @@ void LifetimeImpl::terminate()
 	if (is_eternal())
 		return;
 
+	// set first, so that attach_nested racing with it either sees it or is undone here
 	terminated = true;
 
+	detach_from_parent();
+
 	// region thread-safety section
 
-	actions_t actions_copy;
+	Slots actions_copy;
 	{
 		std::lock_guard<decltype(actions_lock)> guard(actions_lock);
 		actions_copy = std::move(actions);
-
-		actions.clear();
+		removed_actions = 0;
 	}
 	// endregion
 
-	for (auto it = actions_copy.rbegin(); it != actions_copy.rend(); ++it)
+	for (Slot* it = actions_copy.end(); it != actions_copy.begin();)
+	{
+		--it;
+		if (it->nested != nullptr)
+		{
+			it->nested->terminate();
+		}
+		else if (it->action)
+		{
+			it->action();
+		}
+	}
+}
+
+LifetimeImpl::counter_t LifetimeImpl::add_slot(Slot slot)
+{
+	std::lock_guard<decltype(actions_lock)> guard(actions_lock);
+
+	if (is_terminated())
 	{
-		it->second();
+		throw std::invalid_argument("Already Terminated");
+	}
+
+	slot.id = action_id_in_map++;
+	const counter_t slot_id = slot.id;
+	actions.push_back(std::move(slot));
+	return slot_id;
+}
+
+LifetimeImpl::Slot LifetimeImpl::take_action(counter_t i)
+{
+	Slot slot;
+
+	std::lock_guard<decltype(actions_lock)> guard(actions_lock);
+
+	Slot* found = actions.find(i);
+	if (found == nullptr || found->is_empty())
+	{
+		return slot;
+	}
+	slot.action = std::move(found->action);
+	slot.nested = std::move(found->nested);
+	found->action = nullptr;
+	++removed_actions;
+
+	// nested lifetimes are usually terminated in the reverse order, so the freed slots are at the end
+	while (actions.size() > 0 && (actions.end() - 1)->is_empty())
+	{
+		actions.resize_down(actions.size() - 1);
+		--removed_actions;
+	}
+	if (removed_actions > actions.size() / 2)
+	{
+		Slot* last = std::remove_if(actions.begin(), actions.end(), [](Slot const& it) { return it.is_empty(); });
+		actions.resize_down(last - actions.begin());
+		removed_actions = 0;
+	}
+	return slot;
+}
+
+void LifetimeImpl::remove_action(counter_t i)
+{
+	// destroyed outside of the lock
+	Slot slot = take_action(i);
+}
+
+void LifetimeImpl::detach_from_parent()
+{
+	Slot slot;
+	{
+		// held while the parent is accessed, its destructor takes it before forgetting this lifetime
+		std::lock_guard<decltype(actions_lock)> guard(actions_lock);
+		if (parent == nullptr)
+		{
+			return;
+		}
+		slot = parent->take_action(id_in_parent);
+		parent = nullptr;
 	}
 }
 
@@ -51,13 +227,38 @@ void LifetimeImpl::attach_nested(std::shared_ptr<LifetimeImpl> nested)
 	if (nested->is_terminated() || is_eternal())
 		return;
 
-	std::function<void()> action = [nested] { nested->terminate(); };
-	counter_t action_id = add_action(action);
-	nested->add_action([this, id = action_id] { actions.erase(id); });
+	LifetimeImpl& nested_ref = *nested;
+	Slot slot;
+	slot.nested = std::move(nested);
+	const counter_t action_id = add_slot(std::move(slot));
+
+	bool nested_terminated;
+	{
+		std::lock_guard<decltype(actions_lock)> guard(nested_ref.actions_lock);
+		nested_terminated = nested_ref.is_terminated();
+		if (!nested_terminated)
+		{
+			nested_ref.parent = this;
+			nested_ref.id_in_parent = action_id;
+		}
+	}
+	// it has been terminated on another thread meanwhile, before it could detach itself
+	if (nested_terminated)
+	{
+		remove_action(action_id);
+	}
 }
 
 LifetimeImpl::~LifetimeImpl()
 {
+	for (Slot& slot : actions)
+	{
+		if (slot.nested != nullptr)
+		{
+			std::lock_guard<decltype(actions_lock)> guard(slot.nested->actions_lock);
+			slot.nested->parent = nullptr;
+		}
+	}
 	/*if (!is_eternal() && !is_terminated()) {
 		spdlog::error("forget to terminate lifetime with id: {}", to_string(id));
 		terminate();
@@ -9,11 +9,11 @@
 #include <std/hash.h>
 
 #include <functional>
-#include <map>
 #include <memory>
 #include <mutex>
 #include <atomic>
 #include <utility>
+#include <vector>
 
 #include <thirdparty.hpp>
 
@@ -31,18 +31,111 @@ public:
 	using counter_t = int32_t;
 
 private:
+	/**
+	 * \brief Mutex for short critical sections which are almost never contended: a lifetime is usually used by a single
+	 * thread, so taking it costs one atomic exchange.
+	 */
+	class SpinLock
+	{
+		std::atomic_flag flag = ATOMIC_FLAG_INIT;
+
+	public:
+		void lock();
+
+		void unlock()
+		{
+			flag.clear(std::memory_order_release);
+		}
+	};
+
+	/**
+	 * \brief Termination action or nested lifetime. Nested lifetimes are stored as they are, without a closure around them.
+	 */
+	struct Slot
+	{
+		counter_t id = 0;
+		std::function<void()> action;
+		std::shared_ptr<LifetimeImpl> nested;
+
+		bool is_empty() const
+		{
+			return !action && nested == nullptr;
+		}
+	};
+
+	/**
+	 * \brief Slots ordered by id. The first few are stored inline, so that short lived lifetimes don't allocate for them.
+	 */
+	class Slots
+	{
+		static constexpr size_t INLINE_CAPACITY = 2;
+
+		Slot inline_slots[INLINE_CAPACITY];
+		// all slots are moved here once they don't fit inline
+		std::vector<Slot> spilled;
+		bool is_spilled = false;
+		size_t count = 0;
+
+	public:
+		// region ctor/dtor
+
+		Slots() = default;
+
+		Slots(Slots&& other) noexcept;
+
+		Slots& operator=(Slots&& other) noexcept;
+		// endregion
+
+		Slot* begin()
+		{
+			return is_spilled ? spilled.data() : inline_slots;
+		}
+
+		Slot* end()
+		{
+			return begin() + count;
+		}
+
+		size_t size() const
+		{
+			return count;
+		}
+
+		Slot* find(counter_t id);
+
+		void push_back(Slot slot);
+
+		void resize_down(size_t new_count);
+
+		void clear()
+		{
+			resize_down(0);
+		}
+	};
+
 	bool eternaled = false;
 	std::atomic<bool> terminated{false};
 
 	counter_t id = 0;
 
 	counter_t action_id_in_map = 0;
-	using actions_t = ordered_map<int, std::function<void()>, rd::hash<int>>;
-	actions_t actions;
+	Slots actions;
+	// empty slots in [actions], removed ones which aren't at the end
+	size_t removed_actions = 0;
+
+	// lifetime this one is attached to as nested, and the id of its slot there
+	LifetimeImpl* parent = nullptr;
+	counter_t id_in_parent = 0;
+
+	SpinLock actions_lock;
 
 	void terminate();
 
-	std::mutex actions_lock;
+	counter_t add_slot(Slot slot);
+
+	Slot take_action(counter_t i);
+
+	void detach_from_parent();
 
 public:
 	// region ctor/dtor
@@ -56,33 +149,19 @@ public:
 	template <typename F>
 	counter_t add_action(F&& action)
 	{
-		std::lock_guard<decltype(actions_lock)> guard(actions_lock);
-
 		if (is_eternal())
 		{
 			return -1;
 		}
-		if (is_terminated())
-		{
-			throw std::invalid_argument("Already Terminated");
-		}
-
-		actions[action_id_in_map] = std::forward<F>(action);
-		return action_id_in_map++;
+		// constructed outside of the lock, it may allocate
+		Slot slot;
+		slot.action = std::forward<F>(action);
+		return add_slot(std::move(slot));
 	}
 
-	void remove_action(counter_t i)
-	{
-		std::lock_guard<decltype(actions_lock)> guard(actions_lock);
+	void remove_action(counter_t i);
 
-		actions.erase(i);
-	}
-
-#if __cplusplus >= 201703L
-	static inline counter_t get_id = 0;
-#else
-	static counter_t get_id;
-#endif
+	static std::atomic<counter_t> get_id;
 
 	template <typename F, typename G>
 	void bracket(F&& opening, G&& closing)
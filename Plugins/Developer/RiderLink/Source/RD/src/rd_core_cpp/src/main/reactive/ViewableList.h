@@ -20,12 +20,28 @@ class ViewableList : public IViewableList<T>
 public:
 	using Event = typename IViewableList<T>::Event;
 
+	using Batch = typename IViewableList<T>::Batch;
+
 private:
 	using WA = typename std::allocator_traits<A>::template rebind_alloc<Wrapper<T>>;
 
 	using data_t = std::vector<Wrapper<T>, WA>;
 	mutable data_t list;
-	Signal<Event> change;
+	// every operation fires once, per element subscriptions are adapted in [advise]
+	Signal<Batch> change;
+
+	void fire(Event const& e) const
+	{
+		change.fire(Batch(&e, 1));
+	}
+
+	void fire(std::vector<Event> const& events) const
+	{
+		if (!events.empty())
+		{
+			change.fire(Batch(events.data(), events.size()));
+		}
+	}
 
 protected:
 	using WT = typename IViewableList<T>::WT;
@@ -208,24 +224,46 @@ public:
 	{
 		if (lifetime->is_terminated())
 			return;
-		change.advise(lifetime, handler);
+		change.advise(lifetime, [handler](Batch const& batch) {
+			for (auto const& e : batch)
+			{
+				handler(e);
+			}
+		});
 		for (int32_t i = 0; i < static_cast<int32_t>(size()); ++i)
 		{
 			handler(typename Event::Add(i, &(*list[i])));
 		}
 	}
 
+	void advise_batch(Lifetime lifetime, std::function<void(Batch const&)> handler) const override
+	{
+		if (lifetime->is_terminated())
+			return;
+		change.advise(lifetime, handler);
+		std::vector<Event> events;
+		events.reserve(size());
+		for (int32_t i = 0; i < static_cast<int32_t>(size()); ++i)
+		{
+			events.push_back(typename Event::Add(i, &(*list[i])));
+		}
+		if (!events.empty())
+		{
+			handler(Batch(events.data(), events.size()));
+		}
+	}
+
 	bool add(WT element) const override
 	{
 		list.emplace_back(std::move(element));
-		change.fire(typename Event::Add(static_cast<int32_t>(size()) - 1, &(*list.back())));
+		fire(typename Event::Add(static_cast<int32_t>(size()) - 1, &(*list.back())));
 		return true;
 	}
 
 	bool add(size_t index, WT element) const override
 	{
 		list.emplace(list.begin() + index, std::move(element));
-		change.fire(typename Event::Add(static_cast<int32_t>(index), &(*list[index])));
+		fire(typename Event::Add(static_cast<int32_t>(index), &(*list[index])));
 		return true;
 	}
 
@@ -234,7 +272,7 @@ public:
 		auto res = std::move(list[index]);
 		list.erase(list.begin() + index);
 
-		change.fire(typename Event::Remove(static_cast<int32_t>(index), &(*res)));
+		fire(typename Event::Remove(static_cast<int32_t>(index), &(*res)));
 		return wrapper::unwrap<T>(std::move(res));
 	}
 
@@ -258,60 +296,89 @@ public:
 	{
 		auto old_value = std::move(list[index]);
 		list[index] = Wrapper<T>(std::move(element));
-		change.fire(typename Event::Update(static_cast<int32_t>(index), &(*old_value), &(*list[index])));	   //???
+		fire(typename Event::Update(static_cast<int32_t>(index), &(*old_value), &(*list[index])));	  //???
 		return wrapper::unwrap<T>(std::move(old_value));
 	}
 
+	/**
+	 * \brief Inserts [elements] at [index] in one go, subscribers are notified once with additions in order.
+	 */
 	bool addAll(size_t index, std::vector<WT> elements) const override
 	{
-		for (auto& element : elements)
+		list.insert(list.begin() + index, std::make_move_iterator(elements.begin()), std::make_move_iterator(elements.end()));
+
+		std::vector<Event> events;
+		events.reserve(elements.size());
+		for (size_t i = index; i < index + elements.size(); ++i)
 		{
-			ViewableList::add(index, std::move(element));
-			++index;
+			events.push_back(typename Event::Add(static_cast<int32_t>(i), &(*list[i])));
 		}
+		fire(events);
 		return true;
 	}
 
 	bool addAll(std::vector<WT> elements) const override
 	{
-		for (auto&& element : elements)
-		{
-			ViewableList::add(std::move(element));
-		}
-		return true;
+		return ViewableList::addAll(size(), std::move(elements));
 	}
 
 	void clear() const override
 	{
 		std::vector<Event> changes;
+		changes.reserve(size());
 		for (size_t i = size(); i > 0; --i)
 		{
 			changes.push_back(typename Event::Remove(static_cast<int32_t>(i - 1), &(*list[i - 1])));
 		}
-		for (auto const& e : changes)
-		{
-			change.fire(e);
-		}
+		fire(changes);
 		list.clear();
 	}
 
+	/**
+	 * \brief Removes all occurrences of [elements] in a single pass, subscribers are notified once with removals
+	 * from the last one.
+	 */
 	bool removeAll(std::vector<WT> elements) const override
 	{
-		// TO-DO faster
-		//        std::unordered_set<T> set(elements.begin(), elements.end());
-
-		bool res = false;
-		for (size_t i = list.size(); i > 0; --i)
+		// elements may be not hashable, so they are compared one by one, but the list is compacted only once
+		auto contains = [&elements](Wrapper<T> const& x) {
+			return std::any_of(elements.begin(), elements.end(),
+				[&x](auto const& elem) { return wrapper::TransparentKeyEqual<T>()(elem, x); });
+		};
+
+		data_t removed;
+		std::vector<size_t> removed_indices;
+		size_t kept = 0;
+		for (size_t i = 0; i < list.size(); ++i)
 		{
-			auto const& x = list[i - 1];
-			if (std::count_if(elements.begin(), elements.end(),
-					[&x](auto const& elem) { return wrapper::TransparentKeyEqual<T>()(elem, x); }) > 0)
+			if (contains(list[i]))
 			{
-				removeAt(i - 1);
-				res = true;
+				removed.push_back(std::move(list[i]));
+				removed_indices.push_back(i);
 			}
+			else
+			{
+				if (kept != i)
+				{
+					list[kept] = std::move(list[i]);
+				}
+				++kept;
+			}
+		}
+		if (removed.empty())
+		{
+			return false;
 		}
-		return res;
+		list.erase(list.begin() + kept, list.end());
+
+		std::vector<Event> events;
+		events.reserve(removed.size());
+		for (size_t i = removed.size(); i > 0; --i)
+		{
+			events.push_back(typename Event::Remove(static_cast<int32_t>(removed_indices[i - 1]), &(*removed[i - 1])));
+		}
+		fire(events);
+		return true;
 	}
 
 	size_t size() const override
@@ -23,17 +23,33 @@ class ViewableMap : public IViewableMap<K, V>
 public:
 	using Event = typename IViewableMap<K, V>::Event;
 
+	using Batch = typename IViewableMap<K, V>::Batch;
+
 private:
 	using WK = typename IViewableMap<K, V>::WK;
 	using WV = typename IViewableMap<K, V>::WV;
 	using OV = typename IViewableMap<K, V>::OV;
 	using PA = typename std::allocator_traits<VA>::template rebind_alloc<std::pair<Wrapper<K>, Wrapper<V>>>;
 
-	Signal<Event> change;
+	// every operation fires once, per element subscriptions are adapted in [advise]
+	Signal<Batch> change;
 
 	using data_t = ordered_map<Wrapper<K>, Wrapper<V>, wrapper::TransparentHash<K>, wrapper::TransparentKeyEqual<K>, PA>;
 	mutable data_t map;
 
+	void fire(Event const& e) const
+	{
+		change.fire(Batch(&e, 1));
+	}
+
+	void fire(std::vector<Event> const& events) const
+	{
+		if (!events.empty())
+		{
+			change.fire(Batch(events.data(), events.size()));
+		}
+	}
+
 public:
 	// region ctor/dtor
 
@@ -241,7 +257,12 @@ public:
 
 	void advise(Lifetime lifetime, std::function<void(Event const&)> handler) const override
 	{
-		change.advise(lifetime, handler);
+		change.advise(lifetime, [handler](Batch const& batch) {
+			for (auto const& e : batch)
+			{
+				handler(e);
+			}
+		});
 		/*for (auto const &[key, value] : map) {*/
 		for (auto const& it : map)
 		{
@@ -252,6 +273,21 @@ public:
 		}
 	}
 
+	void advise_batch(Lifetime lifetime, std::function<void(Batch const&)> handler) const override
+	{
+		change.advise(lifetime, handler);
+		std::vector<Event> events;
+		events.reserve(map.size());
+		for (auto const& it : map)
+		{
+			events.push_back(typename Event::Add(&(*it.first), &(*it.second)));
+		}
+		if (!events.empty())
+		{
+			handler(Batch(events.data(), events.size()));
+		}
+	}
+
 	const V* get(K const& key) const override
 	{
 		auto it = map.find(key);
@@ -271,7 +307,7 @@ public:
 			auto& it = node.first;
 			auto const& key_ptr = it->first;
 			auto const& value_ptr = it->second;
-			change.fire(typename Event::Add(&(*key_ptr), &(*value_ptr)));
+			fire(typename Event::Add(&(*key_ptr), &(*value_ptr)));
 			return nullptr;
 		}
 		else
@@ -285,7 +321,7 @@ public:
 				Wrapper<V> old_value = std::move(map.at(key));
 
 				map.at(key_ptr) = Wrapper<V>(std::move(value));
-				change.fire(typename Event::Update(&(*key_ptr), &(*old_value), &(*value_ptr)));
+				fire(typename Event::Update(&(*key_ptr), &(*old_value), &(*value_ptr)));
 			}
 			return &*(value_ptr);
 		}
@@ -296,7 +332,7 @@ public:
 		if (map.count(key) > 0)
 		{
 			Wrapper<V> old_value = std::move(map.at(key));
-			change.fire(typename Event::Remove(&key, &(*old_value)));
+			fire(typename Event::Remove(&key, &(*old_value)));
 			map.erase(key);
 			return wrapper::unwrap<V>(std::move(old_value));
 		}
@@ -306,16 +342,41 @@ public:
 	void clear() const override
 	{
 		std::vector<Event> changes;
+		changes.reserve(map.size());
 		/*for (auto const &[key, value] : map) {*/
 		for (auto const& it : map)
 		{
 			changes.push_back(typename Event::Remove(&(*it.first), &(*it.second)));
 		}
-		for (auto const& it : changes)
+		fire(changes);
+		map.clear();
+	}
+
+	/**
+	 * \brief Sets all [entries] in one go, subscribers are notified once with additions and updates in order.
+	 */
+	void setAll(std::vector<std::pair<WK, WV>> entries) const override
+	{
+		std::vector<Event> events;
+		events.reserve(entries.size());
+		// replaced values are alive until subscribers are notified
+		std::vector<Wrapper<V>> old_values;
+		for (auto& entry : entries)
 		{
-			change.fire(it);
+			auto it = map.find(wrapper::get<K>(entry.first));
+			if (it == map.end())
+			{
+				auto node = map.emplace(std::move(entry.first), std::move(entry.second));
+				events.push_back(typename Event::Add(&(*node.first->first), &(*node.first->second)));
+			}
+			else if (*it->second != wrapper::get<V>(entry.second))
+			{
+				old_values.push_back(std::move(it.value()));
+				it.value() = Wrapper<V>(std::move(entry.second));
+				events.push_back(typename Event::Update(&(*it->first), &(*old_values.back()), &(*it->second)));
+			}
 		}
-		map.clear();
+		fire(events);
 	}
 
 	size_t size() const override
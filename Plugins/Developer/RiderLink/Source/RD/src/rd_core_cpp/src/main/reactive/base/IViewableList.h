@@ -118,6 +118,11 @@ public:
 	 */
 	using Event = typename detail::ListEvent<T>;
 
+	/**
+	 * \brief Events of a single operation, e.g. all additions of addAll.
+	 */
+	using Batch = ChangeBatch<Event>;
+
 protected:
 	mutable rd::unordered_map<Lifetime, std::vector<LifetimeDefinition>> lifetimes;
 
@@ -190,8 +195,27 @@ public:
 		});
 	}
 
+	/**
+	 * \brief Adds a subscription to changes of the list, the current elements are reported as additions first.
+	 * Events of addAll and removeAll are delivered one by one after the whole operation has been applied, so the
+	 * [handler] sees the resulting list; their indices are still valid when the events are applied in order.
+	 * Removals of clear are delivered before the list is cleared.
+	 * \param lifetime lifetime of subscription.
+	 * \param handler to be called.
+	 */
 	void advise(Lifetime lifetime, std::function<void(Event const&)> handler) const override = 0;
 
+	/**
+	 * \brief Adds a subscription to changes of the list with all changes of one operation delivered at once.
+	 * Handlers of [advise] receive the same events one by one.
+	 * \param lifetime lifetime of subscription.
+	 * \param handler to be called.
+	 */
+	virtual void advise_batch(Lifetime lifetime, std::function<void(Batch const&)> handler) const
+	{
+		advise(lifetime, [handler = std::move(handler)](Event const& e) { handler(Batch(&e, 1)); });
+	}
+
 	virtual bool add(WT element) const = 0;
 
 	virtual bool add(size_t index, WT element) const = 0;
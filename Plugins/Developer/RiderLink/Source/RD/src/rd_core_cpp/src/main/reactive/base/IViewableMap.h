@@ -11,6 +11,9 @@
 
 #include "thirdparty.hpp"
 
+#include <utility>
+#include <vector>
+
 namespace rd
 {
 namespace detail
@@ -131,6 +134,11 @@ public:
 	 */
 	using Event = typename detail::MapEvent<K, V>;
 
+	/**
+	 * \brief Events of a single operation, e.g. all additions and updates of setAll.
+	 */
+	using Batch = ChangeBatch<Event>;
+
 	// region ctor/dtor
 
 	IViewableMap() = default;
@@ -219,14 +227,43 @@ public:
 			[handler](Lifetime lf, const std::pair<K const*, V const*> entry) { handler(lf, *entry.first, *entry.second); });
 	}
 
+	/**
+	 * \brief Adds a subscription to changes of the map, the current entries are reported as additions first.
+	 * Events of setAll are delivered one by one after all entries have been set, so the [handler] sees the
+	 * resulting map. Removals of clear are delivered before the map is cleared.
+	 * \param lifetime lifetime of subscription.
+	 * \param handler to be called.
+	 */
 	void advise(Lifetime lifetime, std::function<void(Event const&)> handler) const override = 0;
 
+	/**
+	 * \brief Adds a subscription to changes of the map with all changes of one operation delivered at once.
+	 * Handlers of [advise] receive the same events one by one.
+	 * \param lifetime lifetime of subscription.
+	 * \param handler to be called.
+	 */
+	virtual void advise_batch(Lifetime lifetime, std::function<void(Batch const&)> handler) const
+	{
+		advise(lifetime, [handler = std::move(handler)](Event const& e) { handler(Batch(&e, 1)); });
+	}
+
 	virtual const V* get(K const&) const = 0;
 
 	virtual const V* set(WK, WV) const = 0;
 
 	virtual OV remove(K const&) const = 0;
 
+	/**
+	 * \brief Sets all [entries] in one operation, subscribers of [advise_batch] are notified once.
+	 */
+	virtual void setAll(std::vector<std::pair<WK, WV>> entries) const
+	{
+		for (auto& entry : entries)
+		{
+			set(std::move(entry.first), std::move(entry.second));
+		}
+	}
+
 	virtual void clear() const = 0;
 
 	virtual size_t size() const = 0;
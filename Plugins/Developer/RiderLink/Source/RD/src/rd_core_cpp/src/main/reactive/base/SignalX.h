@@ -7,6 +7,8 @@
 #include <lifetime/Lifetime.h>
 #include <util/core_util.h>
 
+#include <algorithm>
+#include <deque>
 #include <utility>
 #include <functional>
 #include <atomic>
@@ -22,67 +24,69 @@ class Signal final : public ISignal<T>
 private:
 	using WT = typename ISignal<T>::WT;
 
-	class Event
+	struct Listener
 	{
-	private:
 		std::function<void(T const&)> action;
 		Lifetime lifetime;
+	};
 
-	public:
-		// region ctor/dtor
-		Event() = delete;
+	// references to the elements stay valid when listeners are advised during fire
+	using listeners_t = std::deque<Listener>;
 
-		template <typename F>
-		Event(F&& action, Lifetime lifetime) : action(std::forward<F>(action)), lifetime(lifetime)
-		{
-		}
+	mutable listeners_t listeners, priority_listeners;
+
+	// depth of nested fire, listeners are removed only outside of it
+	mutable int32_t firing = 0;
+	// some listener was met with terminated lifetime
+	mutable bool has_terminated = false;
 
-		Event(Event&&) = default;
-		// endregion
+	struct FiringGuard
+	{
+		Signal const& signal;
 
-		bool is_alive() const
+		explicit FiringGuard(Signal const& signal) : signal(signal)
 		{
-			return !lifetime->is_terminated();
+			++signal.firing;
 		}
 
-		void execute_if_alive(T const& value) const
+		~FiringGuard()
 		{
-			if (is_alive())
+			if (--signal.firing == 0 && signal.has_terminated)
 			{
-				action(value);
+				signal.cleanup();
 			}
 		}
 	};
 
-	using counter_t = int32_t;
-	using listeners_t = std::map<counter_t, Event>;
-
-	mutable counter_t advise_id = 0;
-	mutable listeners_t listeners, priority_listeners;
-
-	static void cleanup(listeners_t& queue)
+	void cleanup() const
 	{
-		util::erase_if(queue, [](Event const& e) -> bool { return !e.is_alive(); });
+		has_terminated = false;
+		auto is_terminated = [](Listener const& listener) { return listener.lifetime->is_terminated(); };
+		listeners.erase(std::remove_if(listeners.begin(), listeners.end(), is_terminated), listeners.end());
+		priority_listeners.erase(
+			std::remove_if(priority_listeners.begin(), priority_listeners.end(), is_terminated), priority_listeners.end());
 	}
 
 	void fire_impl(T const& value, listeners_t& queue) const
 	{
-		for (auto const& p : queue)
+		// listeners advised by the handlers are invoked as well
+		for (size_t i = 0; i < queue.size(); ++i)
 		{
-			auto const& event = p.second;
-			event.execute_if_alive(value);
+			Listener const& listener = queue[i];
+			if (listener.lifetime->is_terminated())
+			{
+				has_terminated = true;
+				continue;
+			}
+			listener.action(value);
 		}
-		cleanup(queue);
 	}
 
-	template <typename F>
-	void advise0(const Lifetime& lifetime, F&& handler, listeners_t& queue) const
+	void advise0(Lifetime lifetime, std::function<void(T const&)> handler, listeners_t& queue) const
 	{
 		if (lifetime->is_terminated())
 			return;
-		counter_t id = advise_id /*.load()*/;
-		queue.emplace(id, Event(std::forward<F>(handler), lifetime));
-		++advise_id;
+		queue.push_back(Listener{std::move(handler), std::move(lifetime)});
 	}
 
 public:
@@ -106,6 +110,7 @@ public:
 
 	void fire(T const& value) const override
 	{
+		FiringGuard guard(*this);
 		fire_impl(value, priority_listeners);
 		fire_impl(value, listeners);
 	}
@@ -114,7 +119,7 @@ public:
 
 	void advise(Lifetime lifetime, std::function<void(T const&)> handler) const override
 	{
-		advise0(lifetime, std::move(handler), isPriorityAdvise() ? priority_listeners : listeners);
+		advise0(std::move(lifetime), std::move(handler), isPriorityAdvise() ? priority_listeners : listeners);
 	}
 
 	static bool isPriorityAdvise()
@@ -1,6 +1,7 @@
 #ifndef RD_CPP_VIEWABLE_COLLECTIONS_H
 #define RD_CPP_VIEWABLE_COLLECTIONS_H
 
+#include <cstddef>
 #include <string>
 
 namespace rd
@@ -24,6 +25,48 @@ inline std::string to_string(AddRemove kind)
 	}
 }
 
+/**
+ * \brief Changes made to a viewable collection by a single operation, e.g. addAll, in the order they were applied.
+ * Refers to the events owned by the operation, so it's valid only while the handler is called.
+ * \tparam E type of events
+ */
+template <typename E>
+class ChangeBatch
+{
+	E const* events;
+	size_t count;
+
+public:
+	ChangeBatch(E const* events, size_t count) : events(events), count(count)
+	{
+	}
+
+	E const* begin() const
+	{
+		return events;
+	}
+
+	E const* end() const
+	{
+		return events + count;
+	}
+
+	E const& operator[](size_t index) const
+	{
+		return events[index];
+	}
+
+	size_t size() const
+	{
+		return count;
+	}
+
+	bool empty() const
+	{
+		return count == 0;
+	}
+};
+
 enum class Op
 {
 	ADD,
@@ -0,0 +1,609 @@
+#ifndef RD_CPP_FLAT_HASH_MAP_H
+#define RD_CPP_FLAT_HASH_MAP_H
+
+#include "hash.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RD_FLAT_HASH_MAP_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace rd
+{
+namespace detail
+{
+using ctrl_t = int8_t;
+
+// control byte of a slot: h2 of the hash for a full one, otherwise one of these (both negative)
+constexpr ctrl_t CTRL_EMPTY = -128;
+constexpr ctrl_t CTRL_DELETED = -2;
+
+inline uint32_t trailing_zeros(uint32_t mask)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return static_cast<uint32_t>(index);
+#else
+	return static_cast<uint32_t>(__builtin_ctz(mask));
+#endif
+}
+
+/**
+ * \brief Control bytes of 16 consecutive slots, probed at once.
+ */
+class CtrlGroup
+{
+public:
+	static constexpr size_t WIDTH = 16;
+
+#if defined(RD_FLAT_HASH_MAP_SSE2)
+	explicit CtrlGroup(ctrl_t const* pos) : ctrl(_mm_loadu_si128(reinterpret_cast<__m128i const*>(pos)))
+	{
+	}
+
+	uint32_t match(ctrl_t h2) const
+	{
+		return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+	}
+
+	uint32_t match_empty() const
+	{
+		return match(CTRL_EMPTY);
+	}
+
+	uint32_t match_empty_or_deleted() const
+	{
+		return static_cast<uint32_t>(_mm_movemask_epi8(ctrl));
+	}
+
+private:
+	__m128i ctrl;
+#else
+	explicit CtrlGroup(ctrl_t const* pos) : ctrl(pos)
+	{
+	}
+
+	uint32_t match(ctrl_t h2) const
+	{
+		uint32_t mask = 0;
+		for (size_t i = 0; i < WIDTH; ++i)
+		{
+			mask |= static_cast<uint32_t>(ctrl[i] == h2) << i;
+		}
+		return mask;
+	}
+
+	uint32_t match_empty() const
+	{
+		return match(CTRL_EMPTY);
+	}
+
+	uint32_t match_empty_or_deleted() const
+	{
+		uint32_t mask = 0;
+		for (size_t i = 0; i < WIDTH; ++i)
+		{
+			mask |= static_cast<uint32_t>(ctrl[i] < 0) << i;
+		}
+		return mask;
+	}
+
+private:
+	ctrl_t const* ctrl;
+#endif
+};
+
+/**
+ * \brief Spreads sequential ids over the whole hash, so that both the group index and h2 differ.
+ */
+inline uint64_t mix_hash(uint64_t h)
+{
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	return h;
+}
+}	 // namespace detail
+
+/**
+ * \brief Open-addressing hash map for small trivially copyable keys like RdId. Slots are stored in a single array and
+ * looked up by probing 16 control bytes at once, so a lookup costs a cache miss for the control bytes and one for the
+ * slot. Unlike std::unordered_map, references and iterators are invalidated by any insertion.
+ */
+template <typename K, typename V, typename Hash = hash<K>, typename KeyEqual = std::equal_to<K>>
+class flat_hash_map
+{
+	static_assert(std::is_trivially_copyable<K>::value && sizeof(K) <= sizeof(uint64_t),
+		"flat_hash_map is meant for ids, e.g. RdId");
+
+public:
+	using key_type = K;
+	using mapped_type = V;
+	using value_type = std::pair<const K, V>;
+	using size_type = size_t;
+
+private:
+	using ctrl_t = detail::ctrl_t;
+	using Group = detail::CtrlGroup;
+
+	union Slot
+	{
+		Slot()
+		{
+		}
+
+		~Slot()
+		{
+		}
+
+		value_type value;
+	};
+
+	std::unique_ptr<ctrl_t[]> ctrl;
+	std::unique_ptr<Slot[]> slots;
+	size_t capacity_ = 0;
+	size_t size_ = 0;
+	// insertions left before rehash, tombstones count as occupied
+	size_t growth_left = 0;
+
+	Hash hasher;
+	KeyEqual key_equal;
+
+	static size_t max_load(size_t capacity)
+	{
+		return capacity - capacity / 8;
+	}
+
+	uint64_t hash_of(K const& key) const
+	{
+		return detail::mix_hash(static_cast<uint64_t>(hasher(key)));
+	}
+
+	size_t groups_mask() const
+	{
+		return capacity_ / Group::WIDTH - 1;
+	}
+
+	size_t find_index(K const& key) const
+	{
+		if (capacity_ == 0)
+		{
+			return capacity_;
+		}
+		const uint64_t h = hash_of(key);
+		const ctrl_t h2 = static_cast<ctrl_t>(h & 0x7F);
+		const size_t mask = groups_mask();
+		size_t group = static_cast<size_t>(h >> 7) & mask;
+		for (size_t step = 1;; ++step)
+		{
+			const size_t offset = group * Group::WIDTH;
+			Group g(ctrl.get() + offset);
+			for (uint32_t bits = g.match(h2); bits != 0; bits &= bits - 1)
+			{
+				const size_t index = offset + detail::trailing_zeros(bits);
+				if (key_equal(slots[index].value.first, key))
+				{
+					return index;
+				}
+			}
+			// a probe sequence never goes past a group with an empty slot
+			if (g.match_empty() != 0)
+			{
+				return capacity_;
+			}
+			// triangular probing visits every group when their number is a power of two
+			group = (group + step) & mask;
+		}
+	}
+
+	size_t find_free(uint64_t h) const
+	{
+		const size_t mask = groups_mask();
+		size_t group = static_cast<size_t>(h >> 7) & mask;
+		for (size_t step = 1;; ++step)
+		{
+			const size_t offset = group * Group::WIDTH;
+			const uint32_t bits = Group(ctrl.get() + offset).match_empty_or_deleted();
+			if (bits != 0)
+			{
+				return offset + detail::trailing_zeros(bits);
+			}
+			group = (group + step) & mask;
+		}
+	}
+
+	void allocate(size_t capacity)
+	{
+		ctrl.reset(new ctrl_t[capacity]);
+		std::fill(ctrl.get(), ctrl.get() + capacity, detail::CTRL_EMPTY);
+		slots.reset(new Slot[capacity]);
+		capacity_ = capacity;
+		growth_left = max_load(capacity) - size_;
+	}
+
+	void rehash(size_t capacity)
+	{
+		std::unique_ptr<ctrl_t[]> old_ctrl = std::move(ctrl);
+		std::unique_ptr<Slot[]> old_slots = std::move(slots);
+		const size_t old_capacity = capacity_;
+
+		allocate(capacity);
+		for (size_t i = 0; i < old_capacity; ++i)
+		{
+			if (old_ctrl[i] >= 0)
+			{
+				value_type& value = old_slots[i].value;
+				const uint64_t h = hash_of(value.first);
+				const size_t index = find_free(h);
+				ctrl[index] = static_cast<ctrl_t>(h & 0x7F);
+				new (&slots[index].value) value_type(std::move(value));
+				value.~value_type();
+			}
+		}
+	}
+
+	void grow()
+	{
+		if (capacity_ == 0)
+		{
+			rehash(Group::WIDTH);
+		}
+		else if (size_ >= max_load(capacity_) / 2)
+		{
+			rehash(capacity_ * 2);
+		}
+		else
+		{
+			// mostly tombstones, they are dropped in place
+			rehash(capacity_);
+		}
+	}
+
+	void destroy_all()
+	{
+		for (size_t i = 0; i < capacity_; ++i)
+		{
+			if (ctrl[i] >= 0)
+			{
+				slots[i].value.~value_type();
+				ctrl[i] = detail::CTRL_EMPTY;
+			}
+		}
+		size_ = 0;
+		growth_left = max_load(capacity_);
+	}
+
+	void erase_at(size_t index)
+	{
+		slots[index].value.~value_type();
+		--size_;
+		// probes stop at a group with an empty slot, so if there is one the slot may become empty too
+		const size_t offset = index - index % Group::WIDTH;
+		if (Group(ctrl.get() + offset).match_empty() != 0)
+		{
+			ctrl[index] = detail::CTRL_EMPTY;
+			++growth_left;
+		}
+		else
+		{
+			ctrl[index] = detail::CTRL_DELETED;
+		}
+	}
+
+	template <bool Const>
+	class Iterator
+	{
+		friend class flat_hash_map;
+
+		template <bool>
+		friend class Iterator;
+
+		using map_t = typename std::conditional<Const, flat_hash_map const, flat_hash_map>::type;
+
+		map_t* map = nullptr;
+		size_t index = 0;
+
+		Iterator(map_t* map, size_t index) : map(map), index(index)
+		{
+		}
+
+		void skip_free()
+		{
+			while (index < map->capacity_ && map->ctrl[index] < 0)
+			{
+				++index;
+			}
+		}
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = typename flat_hash_map::value_type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = typename std::conditional<Const, value_type const*, value_type*>::type;
+		using reference = typename std::conditional<Const, value_type const&, value_type&>::type;
+
+		Iterator() = default;
+
+		template <bool C = Const, typename = typename std::enable_if<C>::type>
+		Iterator(Iterator<false> const& other) : map(other.map), index(other.index)
+		{
+		}
+
+		reference operator*() const
+		{
+			return map->slots[index].value;
+		}
+
+		pointer operator->() const
+		{
+			return &map->slots[index].value;
+		}
+
+		Iterator& operator++()
+		{
+			++index;
+			skip_free();
+			return *this;
+		}
+
+		Iterator operator++(int)
+		{
+			Iterator res = *this;
+			++*this;
+			return res;
+		}
+
+		friend bool operator==(Iterator const& lhs, Iterator const& rhs)
+		{
+			return lhs.index == rhs.index;
+		}
+
+		friend bool operator!=(Iterator const& lhs, Iterator const& rhs)
+		{
+			return !(lhs == rhs);
+		}
+	};
+
+public:
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
+
+	// region ctor/dtor
+
+	flat_hash_map() = default;
+
+	flat_hash_map(std::initializer_list<value_type> values)
+	{
+		reserve(values.size());
+		for (auto const& value : values)
+		{
+			emplace(value.first, value.second);
+		}
+	}
+
+	flat_hash_map(flat_hash_map const& other) : hasher(other.hasher), key_equal(other.key_equal)
+	{
+		reserve(other.size_);
+		for (auto const& value : other)
+		{
+			emplace(value.first, value.second);
+		}
+	}
+
+	flat_hash_map(flat_hash_map&& other) noexcept
+	{
+		swap(other);
+	}
+
+	flat_hash_map& operator=(flat_hash_map const& other)
+	{
+		if (this != &other)
+		{
+			flat_hash_map copy(other);
+			swap(copy);
+		}
+		return *this;
+	}
+
+	flat_hash_map& operator=(flat_hash_map&& other) noexcept
+	{
+		if (this != &other)
+		{
+			clear();
+			swap(other);
+		}
+		return *this;
+	}
+
+	~flat_hash_map()
+	{
+		destroy_all();
+	}
+	// endregion
+
+	void swap(flat_hash_map& other) noexcept
+	{
+		using std::swap;
+		swap(ctrl, other.ctrl);
+		swap(slots, other.slots);
+		swap(capacity_, other.capacity_);
+		swap(size_, other.size_);
+		swap(growth_left, other.growth_left);
+		swap(hasher, other.hasher);
+		swap(key_equal, other.key_equal);
+	}
+
+	iterator begin()
+	{
+		iterator it(this, 0);
+		it.skip_free();
+		return it;
+	}
+
+	iterator end()
+	{
+		return iterator(this, capacity_);
+	}
+
+	const_iterator begin() const
+	{
+		const_iterator it(this, 0);
+		it.skip_free();
+		return it;
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator(this, capacity_);
+	}
+
+	size_t size() const
+	{
+		return size_;
+	}
+
+	bool empty() const
+	{
+		return size_ == 0;
+	}
+
+	/**
+	 * \brief Makes room for [count] elements without rehashing.
+	 */
+	void reserve(size_t count)
+	{
+		size_t capacity = capacity_ == 0 ? Group::WIDTH : capacity_;
+		while (max_load(capacity) < count)
+		{
+			capacity *= 2;
+		}
+		if (capacity != capacity_)
+		{
+			rehash(capacity);
+		}
+	}
+
+	iterator find(K const& key)
+	{
+		return iterator(this, find_index(key));
+	}
+
+	const_iterator find(K const& key) const
+	{
+		return const_iterator(this, find_index(key));
+	}
+
+	size_t count(K const& key) const
+	{
+		return find_index(key) != capacity_ ? 1 : 0;
+	}
+
+	V& at(K const& key)
+	{
+		const size_t index = find_index(key);
+		if (index == capacity_)
+		{
+			throw std::out_of_range("flat_hash_map::at");
+		}
+		return slots[index].value.second;
+	}
+
+	V const& at(K const& key) const
+	{
+		const size_t index = find_index(key);
+		if (index == capacity_)
+		{
+			throw std::out_of_range("flat_hash_map::at");
+		}
+		return slots[index].value.second;
+	}
+
+	template <typename... Args>
+	std::pair<iterator, bool> try_emplace(K const& key, Args&&... args)
+	{
+		const size_t found = find_index(key);
+		if (found != capacity_)
+		{
+			return {iterator(this, found), false};
+		}
+		if (growth_left == 0)
+		{
+			grow();
+		}
+		const uint64_t h = hash_of(key);
+		const size_t index = find_free(h);
+		new (&slots[index].value)
+			value_type(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+		if (ctrl[index] == detail::CTRL_EMPTY)
+		{
+			--growth_left;
+		}
+		ctrl[index] = static_cast<ctrl_t>(h & 0x7F);
+		++size_;
+		return {iterator(this, index), true};
+	}
+
+	template <typename... Args>
+	std::pair<iterator, bool> emplace(K const& key, Args&&... args)
+	{
+		return try_emplace(key, std::forward<Args>(args)...);
+	}
+
+	V& operator[](K const& key)
+	{
+		return try_emplace(key).first->second;
+	}
+
+	iterator erase(const_iterator pos)
+	{
+		erase_at(pos.index);
+		iterator next(this, pos.index);
+		next.skip_free();
+		return next;
+	}
+
+	iterator erase(iterator pos)
+	{
+		return erase(const_iterator(pos));
+	}
+
+	size_t erase(K const& key)
+	{
+		const size_t index = find_index(key);
+		if (index == capacity_)
+		{
+			return 0;
+		}
+		erase_at(index);
+		return 1;
+	}
+
+	/**
+	 * \brief Destroys all elements, the capacity is kept.
+	 */
+	void clear()
+	{
+		destroy_all();
+	}
+};
+}	 // namespace rd
+
+#endif	  // RD_CPP_FLAT_HASH_MAP_H
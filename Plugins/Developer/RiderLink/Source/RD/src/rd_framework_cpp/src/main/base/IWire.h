@@ -10,6 +10,9 @@
 #include "base/IRdReactive.h"
 #include "reactive/Property.h"
 
+#include <utility>
+#include <vector>
+
 #include <rd_framework_export.h>
 
 namespace rd
@@ -40,6 +43,27 @@ public:
 	 */
 	virtual void send(RdId const& id, std::function<void(Buffer& buffer)> writer) const = 0;
 
+	/**
+	 * \brief Sends several data blocks at once, in a single package if the wire supports it.
+	 * \param messages ids of recipients with the writers of their data, sent in the given order.
+	 */
+	virtual void send_batch(std::vector<std::pair<RdId, std::function<void(Buffer& buffer)>>> const& messages) const
+	{
+		for (auto const& message : messages)
+		{
+			send(message.first, message.second);
+		}
+	}
+
+	/**
+	 * \brief Whether messages sent now are written with varint integrals, see [Buffer::set_varint_integrals].
+	 * Writers copying bytes serialized beforehand must set the mode those bytes were written in on the buffer.
+	 */
+	virtual bool varint_integrals() const
+	{
+		return false;
+	}
+
 	/**
 	 * \brief Adds a [handler] for receiving updated values of the object with the given [id]. The handler is removed
 	 * when the given [lifetime] is terminated.
@@ -0,0 +1,11 @@
+#include "ProtocolTrace.h"
+
+#include "spdlog/sinks/stdout_color_sinks.h"
+
+namespace rd
+{
+std::shared_ptr<spdlog::logger> ProtocolTrace::send =
+	spdlog::stderr_color_mt<spdlog::synchronous_factory>("logSend", spdlog::color_mode::automatic);
+std::shared_ptr<spdlog::logger> ProtocolTrace::received =
+	spdlog::stderr_color_mt<spdlog::synchronous_factory>("logReceived", spdlog::color_mode::automatic);
+}	 // namespace rd
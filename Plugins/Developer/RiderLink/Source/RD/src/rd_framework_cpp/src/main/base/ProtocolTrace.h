@@ -0,0 +1,44 @@
+#ifndef RD_CPP_PROTOCOLTRACE_H
+#define RD_CPP_PROTOCOLTRACE_H
+
+#include "spdlog/spdlog.h"
+
+#include <memory>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Loggers of messages sent and received by reactive entities ("logSend" and "logReceived").
+ * Use them through [RD_TRACE_SEND] and [RD_TRACE_RECEIVED] so that arguments are formatted only when tracing is enabled.
+ */
+class RD_FRAMEWORK_API ProtocolTrace
+{
+public:
+	static std::shared_ptr<spdlog::logger> send;
+	static std::shared_ptr<spdlog::logger> received;
+};
+}	 // namespace rd
+
+// define RD_DISABLE_PROTOCOL_TRACE to compile protocol tracing out entirely
+#if defined(RD_DISABLE_PROTOCOL_TRACE)
+#define RD_PROTOCOL_TRACE(logger, ...) \
+	do                                 \
+	{                                  \
+	} while (false)
+#else
+#define RD_PROTOCOL_TRACE(logger, ...)                    \
+	do                                                    \
+	{                                                     \
+		if ((logger)->should_log(spdlog::level::trace))   \
+		{                                                 \
+			(logger)->trace(__VA_ARGS__);                 \
+		}                                                 \
+	} while (false)
+#endif
+
+#define RD_TRACE_SEND(...) RD_PROTOCOL_TRACE(::rd::ProtocolTrace::send, __VA_ARGS__)
+#define RD_TRACE_RECEIVED(...) RD_PROTOCOL_TRACE(::rd::ProtocolTrace::received, __VA_ARGS__)
+
+#endif	  // RD_CPP_PROTOCOLTRACE_H
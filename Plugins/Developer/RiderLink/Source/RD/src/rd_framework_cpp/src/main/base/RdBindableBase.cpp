@@ -19,14 +19,14 @@ void RdBindableBase::bind(Lifetime lf, IRdDynamic const* parent, string_view nam
 	RD_ASSERT_MSG(!is_bound(), ("Trying to bind already bound this to " + to_string(parent->get_location())));
 	lf->bracket(
 		[this, lf, parent, &name] {
-			this->parent = parent;
+			set_parent(parent);
 			location = parent->get_location().sub(name, ".");
 			this->bind_lifetime = lf;
 		},
 		[this, lf]() {
 			this->bind_lifetime = lf;
-			location = location.sub("<<unbound>>", "::");
-			this->parent = nullptr;
+			// location is kept, interning "<<unbound>>" under it would add a name node per entity
+			set_parent(nullptr);
 			rdid = RdId::Null();
 		});
 
@@ -48,15 +48,28 @@ void RdBindableBase::identify(const Identities& identities, RdId const& id) cons
 	}
 }
 
+void RdBindableBase::set_parent(IRdDynamic const* new_parent) const
+{
+	if (new_parent == nullptr)
+	{
+		parent = nullptr;
+		cached_protocol = nullptr;
+		cached_serialization_context = nullptr;
+		return;
+	}
+	// resolved before anything is assigned, so that a failure leaves this unbound
+	IProtocol const* protocol = new_parent->get_protocol();
+	SerializationCtx& serialization_context = new_parent->get_serialization_context();
+	parent = new_parent;
+	cached_protocol = protocol;
+	cached_serialization_context = &serialization_context;
+}
+
 const IProtocol* RdBindableBase::get_protocol() const
 {
-	if (is_bound())
+	if (cached_protocol != nullptr)
 	{
-		auto protocol = parent->get_protocol();
-		if (protocol != nullptr)
-		{
-			return protocol;
-		}
+		return cached_protocol;
 	}
 	throw std::invalid_argument("Not bound: " + to_string(location));
 }
@@ -78,14 +91,11 @@ void RdBindableBase::set_id(RdId id) const
 
 SerializationCtx& RdBindableBase::get_serialization_context() const
 {
-	if (is_bound())
+	if (cached_serialization_context != nullptr)
 	{
-		return parent->get_serialization_context();
-	}
-	else
-	{
-		throw std::invalid_argument("Not bound: " + to_string(location));
+		return *cached_serialization_context;
 	}
+	throw std::invalid_argument("Not bound: " + to_string(location));
 }
 
 void RdBindableBase::init(Lifetime lifetime) const
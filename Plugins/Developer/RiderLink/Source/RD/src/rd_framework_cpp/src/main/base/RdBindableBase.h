@@ -24,6 +24,15 @@ protected:
 
 	mutable optional<Lifetime> bind_lifetime;
 
+	// resolved through [parent] once bound, entities use them for every message they send
+	mutable IProtocol const* cached_protocol = nullptr;
+	mutable SerializationCtx* cached_serialization_context = nullptr;
+
+	/**
+	 * \brief Binds to [new_parent] and resolves its protocol and serialization context, nullptr unbinds.
+	 */
+	void set_parent(IRdDynamic const* new_parent) const;
+
 	bool is_bound() const;
 
 	const IProtocol* get_protocol() const override;
@@ -79,9 +79,9 @@ public:
 				master_version++;
 			}
 			get_wire()->send(rdid, [this, &v](Buffer& buffer) {
-				buffer.write_integral<int32_t>(master_version);
+				buffer.write_varint<int32_t>(master_version);
 				S::write(this->get_serialization_context(), buffer, v);
-				spdlog::get("logSend")->trace("SEND property {} + {}:: ver = {}, value = {}", to_string(location), to_string(rdid),
+				RD_TRACE_SEND("SEND property {} + {}:: ver = {}, value = {}", to_string(location), to_string(rdid),
 					std::to_string(master_version), to_string(v));
 			});
 		});
@@ -101,11 +101,11 @@ public:
 
 	void on_wire_received(Buffer buffer) const override
 	{
-		int32_t version = buffer.read_integral<int32_t>();
+		int32_t version = buffer.read_varint<int32_t>();
 		WT v = S::read(this->get_serialization_context(), buffer);
 
 		bool rejected = is_master && version < master_version;
-		spdlog::get("logSend")->trace("RECV property {} {}:: oldver={}, ver={}, value = {}{}", to_string(location), to_string(rdid),
+		RD_TRACE_RECEIVED("RECV property {} {}:: oldver={}, ver={}, value = {}{}", to_string(location), to_string(rdid),
 			master_version, version, to_string(v), (rejected ? ">> REJECTED" : ""));
 		if (rejected)
 		{
@@ -1,14 +1,7 @@
 #include "RdReactiveBase.h"
 
-#include "spdlog/sinks/stdout_color_sinks.h"
-
 namespace rd
 {
-static std::shared_ptr<spdlog::logger> logReceived =
-	spdlog::stderr_color_mt<spdlog::synchronous_factory>("logReceived", spdlog::color_mode::automatic);
-std::shared_ptr<spdlog::logger> logSend =
-	spdlog::stderr_color_mt<spdlog::synchronous_factory>("logSend", spdlog::color_mode::automatic);
-
 RdReactiveBase::RdReactiveBase(RdReactiveBase&& other) : RdBindableBase(std::move(other)) /*, async(other.async)*/
 {
 	async = other.async;
@@ -3,6 +3,7 @@
 
 #include "base/RdBindableBase.h"
 #include "base/IRdReactive.h"
+#include "base/ProtocolTrace.h"
 #include "guards.h"
 
 #include "spdlog/spdlog.h"
@@ -17,11 +17,14 @@ ExtWire::ExtWire()
 					{
 						return;
 					}
-					// auto[id, payload] = std::move(sendQ.front());
-					auto it = std::move(sendQ.front());
+					auto message = std::move(sendQ.front());
 					sendQ.pop();
-					realWire->send(
-						it.first, [payload = std::move(it.second)](Buffer& buffer) { buffer.write_byte_array_raw(payload); });
+					realWire->send(message.id,
+						[payload = std::move(message.payload), varint_integrals = message.varint_integrals](Buffer& buffer) {
+							// writers may have switched the mode themselves, e.g. RdCall::Batch
+							buffer.set_varint_integrals(varint_integrals);
+							buffer.write_byte_array_raw(payload);
+						});
 				}
 			}
 		}
@@ -39,12 +42,20 @@ void ExtWire::send(RdId const& id, std::function<void(Buffer& buffer)> writer) c
 		std::lock_guard<decltype(lock)> guard(lock);
 		if (!sendQ.empty() || !connected.get())
 		{
+			// queued messages are written with fixed width integrals unless the writer switches the mode
 			Buffer buffer;
 			writer(buffer);
-			sendQ.emplace(id, buffer.getRealArray());
+			const bool varint_integrals = buffer.varint_integrals();
+			sendQ.push(QueuedMessage{id, std::move(buffer).getRealArray(), varint_integrals});
 			return;
 		}
 	}
 	realWire->send(id, std::move(writer));
 }
+
+bool ExtWire::varint_integrals() const
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+	return sendQ.empty() && connected.get() && realWire->varint_integrals();
+}
 }	 // namespace rd
@@ -22,7 +22,17 @@ class RD_FRAMEWORK_API ExtWire final : public IWire
 {
 	mutable std::mutex lock;
 
-	mutable std::queue<std::pair<RdId, Buffer::ByteArray> > sendQ;
+	/**
+	 * \brief Message written while disconnected, replayed in the integrals mode it was written in.
+	 */
+	struct QueuedMessage
+	{
+		RdId id;
+		Buffer::ByteArray payload;
+		bool varint_integrals;
+	};
+
+	mutable std::queue<QueuedMessage> sendQ;
 
 public:
 	ExtWire();
@@ -32,6 +42,8 @@ public:
 	void advise(Lifetime lifetime, RdReactiveBase const* entity) const override;
 
 	void send(RdId const& id, std::function<void(Buffer& buffer)> writer) const override;
+
+	bool varint_integrals() const override;
 };
 }	 // namespace rd
 #if defined(_MSC_VER)
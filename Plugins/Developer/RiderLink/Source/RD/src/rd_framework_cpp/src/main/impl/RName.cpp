@@ -2,67 +2,303 @@
 
 #include "thirdparty.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
 namespace rd
 {
 class RNameImpl
 {
 public:
-	// region ctor/dtor
-	RNameImpl(RName parent, string_view localName, string_view separator);
+	/**
+	 * \brief Returns the node of [parent] [separator] [local_name] with a reference taken for the caller.
+	 */
+	static RNameImpl* intern(RNameImpl* parent, string_view local_name, string_view separator);
+
+	static void acquire(RNameImpl* impl)
+	{
+		impl->refs.fetch_add(1, std::memory_order_relaxed);
+	}
 
-	RNameImpl(const RName& other) = delete;
-	RNameImpl(RName&& other) noexcept = delete;
+	static void release(RNameImpl* impl);
+
+	string_view path() const;
+
+	// region ctor/dtor
+	RNameImpl(const RNameImpl& other) = delete;
+	RNameImpl(RNameImpl&& other) noexcept = delete;
 	RNameImpl& operator=(const RNameImpl& other) = delete;
 	RNameImpl& operator=(RNameImpl&& other) noexcept = delete;
 	// endregion
 
-	friend std::string to_string(RNameImpl const& value);
-
 private:
-	RName parent;
-	std::string local_name, separator;
+	/**
+	 * \brief Chained hash table of the living nodes, linked through the nodes themselves.
+	 */
+	struct Table
+	{
+		std::mutex lock;
+		std::vector<RNameImpl*> buckets = std::vector<RNameImpl*>(256, nullptr);
+		size_t count = 0;
+
+		RNameImpl*& bucket_of(size_t hash)
+		{
+			return buckets[hash & (buckets.size() - 1)];
+		}
+
+		void link(RNameImpl* node)
+		{
+			if (count >= buckets.size())
+			{
+				std::vector<RNameImpl*> old = std::move(buckets);
+				buckets.assign(old.size() * 2, nullptr);
+				for (RNameImpl* it : old)
+				{
+					while (it != nullptr)
+					{
+						RNameImpl* next = it->next;
+						RNameImpl*& head = bucket_of(it->hash);
+						it->next = head;
+						head = it;
+						it = next;
+					}
+				}
+			}
+			RNameImpl*& head = bucket_of(node->hash);
+			node->next = head;
+			head = node;
+			node->linked = true;
+			++count;
+		}
+
+		void unlink(RNameImpl* node)
+		{
+			for (RNameImpl** it = &bucket_of(node->hash); *it != nullptr; it = &(*it)->next)
+			{
+				if (*it == node)
+				{
+					*it = node->next;
+					break;
+				}
+			}
+			node->next = nullptr;
+			node->linked = false;
+			--count;
+		}
+	};
+
+	// never destroyed, names in static objects may outlive any other static
+	static Table& table()
+	{
+		static Table* instance = new Table();
+		return *instance;
+	}
+
+	static size_t hash_of(RNameImpl const* parent, string_view local_name, string_view separator)
+	{
+		uint64_t h = 14695981039346656037ULL ^ static_cast<uint64_t>(reinterpret_cast<uintptr_t>(parent));
+		for (char c : separator)
+		{
+			h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+		}
+		h = (h ^ 0xFF) * 1099511628211ULL;
+		for (char c : local_name)
+		{
+			h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+		}
+		return static_cast<size_t>(h ^ (h >> 32));
+	}
+
+	RNameImpl(RNameImpl* parent, string_view local_name, string_view separator, size_t hash)
+		: parent(parent), hash(hash), separator_size(separator.size()), local_name_size(local_name.size())
+	{
+		char* chars = reinterpret_cast<char*>(this + 1);
+		std::copy_n(separator.data(), separator_size, chars);
+		std::copy_n(local_name.data(), local_name_size, chars + separator_size);
+	}
+
+	~RNameImpl()
+	{
+		delete path_cache.load(std::memory_order_relaxed);
+	}
+
+	string_view separator() const
+	{
+		return string_view(reinterpret_cast<char const*>(this + 1), separator_size);
+	}
+
+	string_view local_name() const
+	{
+		return string_view(reinterpret_cast<char const*>(this + 1) + separator_size, local_name_size);
+	}
+
+	std::atomic<int32_t> refs{1};
+	// holds a reference to the parent
+	RNameImpl* const parent;
+	const size_t hash;
+	const size_t separator_size;
+	const size_t local_name_size;
+	mutable std::atomic<std::string const*> path_cache{nullptr};
+	// guarded by the table lock
+	RNameImpl* next = nullptr;
+	bool linked = false;
+	// followed by separator and local name chars
 };
 
-RNameImpl::RNameImpl(RName parent, string_view localName, string_view separator)
-	: parent(parent), local_name(localName), separator(separator)
+RNameImpl* RNameImpl::intern(RNameImpl* parent, string_view local_name, string_view separator)
+{
+	const size_t hash = hash_of(parent, local_name, separator);
+
+	Table& t = table();
+	std::lock_guard<std::mutex> guard(t.lock);
+
+	for (RNameImpl* node = t.bucket_of(hash); node != nullptr; node = node->next)
+	{
+		if (node->hash != hash || node->parent != parent || node->local_name() != local_name || node->separator() != separator)
+		{
+			continue;
+		}
+		int32_t refs = node->refs.load(std::memory_order_relaxed);
+		while (refs > 0)
+		{
+			if (node->refs.compare_exchange_weak(refs, refs + 1, std::memory_order_relaxed))
+			{
+				return node;
+			}
+		}
+		// its last reference is being released on another thread, which will find it unlinked
+		t.unlink(node);
+		break;
+	}
+
+	if (parent != nullptr)
+	{
+		acquire(parent);
+	}
+	void* memory = ::operator new(sizeof(RNameImpl) + separator.size() + local_name.size());
+	RNameImpl* node = new (memory) RNameImpl(parent, local_name, separator, hash);
+	t.link(node);
+	return node;
+}
+
+void RNameImpl::release(RNameImpl* impl)
 {
+	// parents are released in a loop, long paths would go deep otherwise
+	while (impl != nullptr && impl->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		{
+			Table& t = table();
+			std::lock_guard<std::mutex> guard(t.lock);
+			if (impl->linked)
+			{
+				t.unlink(impl);
+			}
+		}
+		RNameImpl* parent = impl->parent;
+		impl->~RNameImpl();
+		::operator delete(impl);
+		impl = parent;
+	}
 }
 
-RName::RName(RName parent, string_view localName, string_view separator)
-	: impl(std::make_shared<RNameImpl>(std::move(parent), localName, separator))
+string_view RNameImpl::path() const
+{
+	if (parent == nullptr)
+	{
+		return local_name();
+	}
+	std::string const* cached = path_cache.load(std::memory_order_acquire);
+	if (cached != nullptr)
+	{
+		return *cached;
+	}
+
+	const string_view parent_path = parent->path();
+	auto* created = new std::string();
+	created->reserve(parent_path.size() + separator_size + local_name_size);
+	created->append(parent_path.data(), parent_path.size());
+	created->append(reinterpret_cast<char const*>(this + 1), separator_size + local_name_size);
+	// computed concurrently on another thread, its result is kept
+	if (!path_cache.compare_exchange_strong(cached, created, std::memory_order_acq_rel))
+	{
+		delete created;
+		return *cached;
+	}
+	return *created;
+}
+
+RName::RName(const RName& other) : impl(other.impl)
 {
+	if (impl != nullptr)
+	{
+		RNameImpl::acquire(impl);
+	}
 }
 
-RName RName::sub(string_view localName, string_view separator) const
+RName::RName(RName&& other) noexcept : impl(other.impl)
 {
-	return RName(*this, localName, separator);
+	other.impl = nullptr;
 }
 
-std::string to_string(RName const& value)
+RName& RName::operator=(const RName& other)
 {
-	std::string res;
-	if (value.impl)
+	if (impl != other.impl)
 	{
-		res = to_string(*value.impl);
+		RNameImpl* old = impl;
+		impl = other.impl;
+		if (impl != nullptr)
+		{
+			RNameImpl::acquire(impl);
+		}
+		RNameImpl::release(old);
 	}
-	return res;
+	return *this;
 }
 
-std::string to_string(RNameImpl const& value)
+RName& RName::operator=(RName&& other) noexcept
 {
-	if (value.parent)
+	if (this != &other)
 	{
-		std::string res;
-		res = to_string(value.parent);
-		res += value.separator;
-		res += value.local_name;
-		return res;
+		RNameImpl::release(impl);
+		impl = other.impl;
+		other.impl = nullptr;
 	}
-	return value.local_name;
+	return *this;
+}
+
+RName::RName(RName parent, string_view localName, string_view separator)
+	: impl(RNameImpl::intern(parent.impl, localName, separator))
+{
 }
 
-RName::RName(string_view local_name) : RName(RName(), local_name, "")
+RName::RName(string_view local_name) : impl(RNameImpl::intern(nullptr, local_name, ""))
 {
 }
 
+RName::~RName()
+{
+	RNameImpl::release(impl);
+}
+
+RName RName::sub(string_view localName, string_view separator) const
+{
+	RName res;
+	res.impl = RNameImpl::intern(impl, localName, separator);
+	return res;
+}
+
+string_view RName::str() const
+{
+	return impl != nullptr ? impl->path() : string_view();
+}
+
+std::string to_string(RName const& value)
+{
+	const string_view path = value.str();
+	return std::string(path.data(), path.size());
+}
 }	 // namespace rd
@@ -17,6 +17,9 @@ class RNameImpl;
 
 /**
  * \brief Recursive name. For constructs like Aaaa.Bbb::CCC
+ *
+ * Names are interned: equal paths share a single node, so binding the same model again allocates nothing and copies
+ * are reference counted handles. The full path is built on first use and cached in the node.
  */
 class RD_FRAMEWORK_API RName
 {
@@ -25,17 +28,19 @@ public:
 
 	RName() = default;
 
-	RName(const RName& other) = default;
+	RName(const RName& other);
 
-	RName(RName&& other) noexcept = default;
+	RName(RName&& other) noexcept;
 
-	RName& operator=(const RName& other) = default;
+	RName& operator=(const RName& other);
 
-	RName& operator=(RName&& other) noexcept = default;
+	RName& operator=(RName&& other) noexcept;
 
 	RName(RName parent, string_view localName, string_view separator);
 
 	explicit RName(string_view local_name);
+
+	~RName();
 	// endregion
 
 	RName sub(string_view localName, string_view separator) const;
@@ -45,10 +50,25 @@ public:
 		return impl != nullptr;
 	}
 
+	/**
+	 * \brief Full path, valid as long as this name or any copy of it.
+	 */
+	string_view str() const;
+
+	friend bool operator==(RName const& lhs, RName const& rhs)
+	{
+		return lhs.impl == rhs.impl;
+	}
+
+	friend bool operator!=(RName const& lhs, RName const& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
 	friend std::string RD_FRAMEWORK_API to_string(RName const& value);
 
 private:
-	std::shared_ptr<RNameImpl> impl;
+	RNameImpl* impl = nullptr;
 };
 }	 // namespace rd
 #if defined(_MSC_VER)
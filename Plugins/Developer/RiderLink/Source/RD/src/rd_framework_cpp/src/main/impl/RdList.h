@@ -6,6 +6,9 @@
 #include "serialization/Polymorphic.h"
 #include "std/allocator.h"
 
+#include <utility>
+#include <vector>
+
 #if defined(_MSC_VER)
 #pragma warning(push)
 #pragma warning(disable : 4250)
@@ -40,6 +43,8 @@ private:
 public:
 	using Event = typename IViewableList<T>::Event;
 
+	using Batch = typename IViewableList<T>::Batch;
+
 	using value_t = T;
 	// region ctor/dtor
 
@@ -55,7 +60,7 @@ public:
 	static RdList<T, S> read(SerializationCtx& /*ctx*/, Buffer& buffer)
 	{
 		RdList<T, S> result;
-		int64_t next_version = buffer.read_integral<int64_t>();
+		int64_t next_version = buffer.read_varint<int64_t>();
 		RdId id = RdId::read(buffer);
 
 		result.next_version = next_version;
@@ -65,7 +70,7 @@ public:
 
 	void write(SerializationCtx& /*ctx*/, Buffer& buffer) const override
 	{
-		buffer.write_integral<int64_t>(next_version);
+		buffer.write_varint<int64_t>(next_version);
 		rdid.write(buffer);
 	}
 
@@ -78,34 +83,53 @@ public:
 		RdBindableBase::init(lifetime);
 
 		local_change([this, lifetime] {
-			advise(lifetime, [this, lifetime](typename IViewableList<T>::Event e) {
+			advise_batch(lifetime, [this](Batch const& batch) {
 				if (!is_local_change)
 					return;
 
 				if (!optimize_nested)
 				{
-					T const* new_value = e.get_new_value();
-					if (new_value)
+					for (auto const& e : batch)
 					{
-						const IProtocol* iProtocol = get_protocol();
-						const Identities* identity = iProtocol->get_identity();
-						identifyPolymorphic(*new_value, *identity, identity->next(rdid));
+						T const* new_value = e.get_new_value();
+						if (new_value)
+						{
+							const IProtocol* iProtocol = get_protocol();
+							const Identities* identity = iProtocol->get_identity();
+							identifyPolymorphic(*new_value, *identity, identity->next(rdid));
+						}
 					}
 				}
 
-				get_wire()->send(rdid, [this, e](Buffer& buffer) {
-					Op op = static_cast<Op>(e.v.index());
+				auto writer = [this](Event const& e) {
+					return [this, e](Buffer& buffer) {
+						Op op = static_cast<Op>(e.v.index());
 
-					buffer.write_integral<int64_t>(static_cast<int64_t>(op) | (next_version++ << versionedFlagShift));
-					buffer.write_integral<int32_t>(static_cast<const int32_t>(e.get_index()));
+						buffer.write_varint<int64_t>(static_cast<int64_t>(op) | (next_version++ << versionedFlagShift));
+						buffer.write_varint<int32_t>(static_cast<const int32_t>(e.get_index()));
 
-					T const* new_value = e.get_new_value();
-					if (new_value)
-					{
-						S::write(this->get_serialization_context(), buffer, *new_value);
-					}
-					spdlog::get("logSend")->trace(logmsg(op, next_version - 1, e.get_index(), new_value));
-				});
+						T const* new_value = e.get_new_value();
+						if (new_value)
+						{
+							S::write(this->get_serialization_context(), buffer, *new_value);
+						}
+						RD_TRACE_SEND(logmsg(op, next_version - 1, e.get_index(), new_value));
+					};
+				};
+
+				if (batch.size() == 1)
+				{
+					get_wire()->send(rdid, writer(batch[0]));
+					return;
+				}
+				// counterpart applies them one by one, but they are sent in a single package
+				std::vector<std::pair<RdId, std::function<void(Buffer& buffer)>>> messages;
+				messages.reserve(batch.size());
+				for (auto const& e : batch)
+				{
+					messages.emplace_back(rdid, writer(e));
+				}
+				get_wire()->send_batch(messages);
 			});
 		});
 
@@ -121,10 +145,10 @@ public:
 
 	void on_wire_received(Buffer buffer) const override
 	{
-		int64_t header = (buffer.read_integral<int64_t>());
+		int64_t header = (buffer.read_varint<int64_t>());
 		int64_t version = header >> versionedFlagShift;
 		Op op = static_cast<Op>((header & ((1 << versionedFlagShift) - 1L)));
-		int32_t index = (buffer.read_integral<int32_t>());
+		int32_t index = (buffer.read_varint<int32_t>());
 
 		RD_ASSERT_MSG(version == next_version,
 			("Version conflict for " + to_string(location) + "}. Expected version " + std::to_string(next_version) + ", received " +
@@ -138,7 +162,7 @@ public:
 			{
 				auto value = S::read(this->get_serialization_context(), buffer);
 
-				spdlog::get("logReceived")->trace(logmsg(op, version, index, &(wrapper::get<T>(value))));
+				RD_TRACE_RECEIVED(logmsg(op, version, index, &(wrapper::get<T>(value))));
 
 				(index < 0) ? list::add(std::move(value)) : list::add(static_cast<size_t>(index), std::move(value));
 				break;
@@ -147,14 +171,14 @@ public:
 			{
 				auto value = S::read(this->get_serialization_context(), buffer);
 
-				spdlog::get("logReceived")->trace(logmsg(op, version, index, &(wrapper::get<T>(value))));
+				RD_TRACE_RECEIVED(logmsg(op, version, index, &(wrapper::get<T>(value))));
 
 				list::set(static_cast<size_t>(index), std::move(value));
 				break;
 			}
 			case Op::REMOVE:
 			{
-				spdlog::get("logReceived")->trace(logmsg(op, version, index));
+				RD_TRACE_RECEIVED(logmsg(op, version, index));
 
 				list::removeAt(static_cast<size_t>(index));
 				break;
@@ -173,6 +197,15 @@ public:
 		list::advise(lifetime, handler);
 	}
 
+	void advise_batch(Lifetime lifetime, std::function<void(Batch const&)> handler) const override
+	{
+		if (is_bound())
+		{
+			assert_threading();
+		}
+		list::advise_batch(lifetime, handler);
+	}
+
 	bool add(WT element) const override
 	{
 		return local_change([this, element = std::move(element)]() mutable { return list::add(std::move(element)); });
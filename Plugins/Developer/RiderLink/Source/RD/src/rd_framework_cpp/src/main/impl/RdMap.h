@@ -7,6 +7,8 @@
 #include "util/shared_function.h"
 
 #include <cstdint>
+#include <utility>
+#include <vector>
 
 #if defined(_MSC_VER)
 #pragma warning(push)
@@ -57,6 +59,8 @@ public:
 
 	using Event = typename IViewableMap<K, V>::Event;
 
+	using Batch = typename IViewableMap<K, V>::Batch;
+
 	using key_type = K;
 	using value_type = V;
 
@@ -91,42 +95,61 @@ public:
 		RdBindableBase::init(lifetime);
 
 		local_change([this, lifetime]() {
-			advise(lifetime, [this, lifetime](Event e) {
+			advise_batch(lifetime, [this](Batch const& batch) {
 				if (!is_local_change)
 					return;
 
-				V const* new_value = e.get_new_value();
-				if (new_value)
+				for (auto const& e : batch)
 				{
-					const IProtocol* iProtocol = get_protocol();
-					const Identities* identity = iProtocol->get_identity();
-					identifyPolymorphic(*new_value, *identity, identity->next(rdid));
+					V const* new_value = e.get_new_value();
+					if (new_value)
+					{
+						const IProtocol* iProtocol = get_protocol();
+						const Identities* identity = iProtocol->get_identity();
+						identifyPolymorphic(*new_value, *identity, identity->next(rdid));
+					}
 				}
 
-				get_wire()->send(rdid, [this, e](Buffer& buffer) {
-					int32_t versionedFlag = ((is_master ? 1 : 0)) << versionedFlagShift;
-					Op op = static_cast<Op>(e.v.index());
+				auto writer = [this](Event const& e) {
+					return [this, e](Buffer& buffer) {
+						int32_t versionedFlag = ((is_master ? 1 : 0)) << versionedFlagShift;
+						Op op = static_cast<Op>(e.v.index());
 
-					buffer.write_integral<int32_t>(static_cast<int32_t>(op) | versionedFlag);
+						buffer.write_varint<int32_t>(static_cast<int32_t>(op) | versionedFlag);
 
-					int64_t version = is_master ? ++next_version : 0L;
+						int64_t version = is_master ? ++next_version : 0L;
 
-					if (is_master)
-					{
-						pendingForAck.emplace(e.get_key(), version);
-						buffer.write_integral(version);
-					}
+						if (is_master)
+						{
+							pendingForAck.emplace(e.get_key(), version);
+							buffer.write_varint(version);
+						}
 
-					KS::write(this->get_serialization_context(), buffer, *e.get_key());
+						KS::write(this->get_serialization_context(), buffer, *e.get_key());
 
-					V const* new_value = e.get_new_value();
-					if (new_value)
-					{
-						VS::write(this->get_serialization_context(), buffer, *new_value);
-					}
+						V const* new_value = e.get_new_value();
+						if (new_value)
+						{
+							VS::write(this->get_serialization_context(), buffer, *new_value);
+						}
+
+						RD_TRACE_SEND("SEND{}", logmsg(op, next_version - 1, e.get_key(), new_value));
+					};
+				};
 
-					spdlog::get("logSend")->trace("SEND{}", logmsg(op, next_version - 1, e.get_key(), new_value));
-				});
+				if (batch.size() == 1)
+				{
+					get_wire()->send(rdid, writer(batch[0]));
+					return;
+				}
+				// counterpart applies them one by one, but they are sent in a single package
+				std::vector<std::pair<RdId, std::function<void(Buffer& buffer)>>> messages;
+				messages.reserve(batch.size());
+				for (auto const& e : batch)
+				{
+					messages.emplace_back(rdid, writer(e));
+				}
+				get_wire()->send_batch(messages);
 			});
 		});
 
@@ -140,11 +163,11 @@ public:
 
 	void on_wire_received(Buffer buffer) const override
 	{
-		int32_t header = buffer.read_integral<int32_t>();
+		int32_t header = buffer.read_varint<int32_t>();
 		bool msg_versioned = (header >> versionedFlagShift) != 0;
 		Op op = static_cast<Op>(header & ((1 << versionedFlagShift) - 1));
 
-		int64_t version = msg_versioned ? buffer.read_integral<int64_t>() : 0;
+		int64_t version = msg_versioned ? buffer.read_varint<int64_t>() : 0;
 
 		WK key = KS::read(this->get_serialization_context(), buffer);
 
@@ -186,16 +209,17 @@ public:
 			}
 			if (errmsg.empty())
 			{
-				spdlog::get("logReceived")->trace(logmsg(Op::ACK, version, &(wrapper::get<K>(key))));
+				RD_TRACE_RECEIVED(logmsg(Op::ACK, version, &(wrapper::get<K>(key))));
 			}
 			else
 			{
-				spdlog::get("logReceived")->error(logmsg(Op::ACK, version, &(wrapper::get<K>(key))) + " >> " + errmsg);
+				ProtocolTrace::received->error(logmsg(Op::ACK, version, &(wrapper::get<K>(key))) + " >> " + errmsg);
 			}
 		}
 		else
 		{
 			Buffer serialized_key;
+			serialized_key.set_varint_integrals(get_wire()->varint_integrals());
 			KS::write(this->get_serialization_context(), serialized_key, wrapper::get<K>(key));
 
 			bool is_put = (op == Op::ADD || op == Op::UPDATE);
@@ -207,7 +231,7 @@ public:
 
 			if (msg_versioned || !is_master || pendingForAck.count(key) == 0)
 			{
-				spdlog::get("logReceived")->trace("RECV{}", logmsg(op, version, &(wrapper::get<K>(key)), value));
+				RD_TRACE_RECEIVED("RECV{}", logmsg(op, version, &(wrapper::get<K>(key)), value));
 				if (value.has_value())
 				{
 					map::set(std::move(key), *std::move(value));
@@ -219,15 +243,16 @@ public:
 			}
 			else
 			{
-				spdlog::get("logReceived")->trace("{} >> REJECTED", logmsg(op, version, &(wrapper::get<K>(key)), value));
+				RD_TRACE_RECEIVED("{} >> REJECTED", logmsg(op, version, &(wrapper::get<K>(key)), value));
 			}
 
 			if (msg_versioned)
 			{
 				auto writer =
 					util::make_shared_function([version, serialized_key = std::move(serialized_key)](Buffer& innerBuffer) mutable {
-						innerBuffer.write_integral<int32_t>((1u << versionedFlagShift) | static_cast<int32_t>(Op::ACK));
-						innerBuffer.write_integral<int64_t>(version);
+						innerBuffer.set_varint_integrals(serialized_key.varint_integrals());
+						innerBuffer.write_varint<int32_t>((1u << versionedFlagShift) | static_cast<int32_t>(Op::ACK));
+						innerBuffer.write_varint<int64_t>(version);
 						// KS::write(this->get_serialization_context(), innerBuffer, wrapper::get<K>(key));
 						innerBuffer.write_byte_array_raw(serialized_key.getArray());
 						// logSend.trace(logmsg(Op::ACK, version, serialized_key));
@@ -235,7 +260,7 @@ public:
 				get_wire()->send(rdid, std::move(writer));
 				if (is_master)
 				{
-					spdlog::get("logReceived")->error("Both ends are masters: {}", to_string(location));
+					ProtocolTrace::received->error("Both ends are masters: {}", to_string(location));
 				}
 			}
 		}
@@ -250,6 +275,15 @@ public:
 		map::advise(lifetime, handler);
 	}
 
+	void advise_batch(Lifetime lifetime, std::function<void(Batch const&)> handler) const override
+	{
+		if (is_bound())
+		{
+			assert_threading();
+		}
+		map::advise_batch(lifetime, handler);
+	}
+
 	V const* get(K const& key) const override
 	{
 		return local_change([&] { return map::get(key); });
@@ -260,6 +294,11 @@ public:
 		return local_change([&]() mutable { return map::set(std::move(key), std::move(value)); });
 	}
 
+	void setAll(std::vector<std::pair<WK, WV>> entries) const override
+	{
+		local_change([&]() mutable { map::setAll(std::move(entries)); });
+	}
+
 	OV remove(K const& key) const override
 	{
 		return local_change([&] { return map::remove(key); });
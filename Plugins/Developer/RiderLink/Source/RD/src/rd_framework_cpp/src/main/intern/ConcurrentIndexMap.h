@@ -0,0 +1,178 @@
+#ifndef RD_CPP_CONCURRENTINDEXMAP_H
+#define RD_CPP_CONCURRENTINDEXMAP_H
+
+#include "std/hash.h"
+
+#include "thirdparty.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace rd
+{
+/**
+ * \brief Insert-only map from keys to indices which is read without any lock. Writers are serialized, a table is
+ * replaced by a twice larger one when it's half full and kept until [clear], as readers may still probe it.
+ * A reader probing a replaced table may miss keys added after the replacement.
+ */
+template <typename K, typename Hash = hash<K>, typename KeyEqual = std::equal_to<K>>
+class ConcurrentIndexMap
+{
+	struct Entry
+	{
+		Entry(size_t hash, K key, int32_t index) : hash(hash), key(std::move(key)), index(index)
+		{
+		}
+
+		const size_t hash;
+		const K key;
+		std::atomic<int32_t> index;
+	};
+
+	struct Table
+	{
+		explicit Table(size_t capacity) : mask(capacity - 1), slots(new std::atomic<Entry*>[capacity])
+		{
+			for (size_t i = 0; i < capacity; ++i)
+			{
+				slots[i].store(nullptr, std::memory_order_relaxed);
+			}
+		}
+
+		const size_t mask;
+		std::unique_ptr<std::atomic<Entry*>[]> slots;
+	};
+
+	static constexpr size_t INITIAL_CAPACITY = 64;
+
+	std::atomic<Table*> current{nullptr};
+	// guarded by [write_lock]
+	std::vector<std::unique_ptr<Table>> tables;
+	std::vector<std::unique_ptr<Entry>> entries;
+	std::mutex write_lock;
+
+	Hash hasher;
+	KeyEqual key_equal;
+
+	Entry* find_entry(Table const* table, K const& key, size_t hash) const
+	{
+		if (table == nullptr)
+		{
+			return nullptr;
+		}
+		for (size_t i = hash & table->mask;; i = (i + 1) & table->mask)
+		{
+			Entry* entry = table->slots[i].load(std::memory_order_acquire);
+			if (entry == nullptr)
+			{
+				return nullptr;
+			}
+			if (entry->hash == hash && key_equal(entry->key, key))
+			{
+				return entry;
+			}
+		}
+	}
+
+	static void place(Table& table, Entry* entry)
+	{
+		size_t i = entry->hash & table.mask;
+		while (table.slots[i].load(std::memory_order_relaxed) != nullptr)
+		{
+			i = (i + 1) & table.mask;
+		}
+		table.slots[i].store(entry, std::memory_order_release);
+	}
+
+	// under [write_lock]
+	void add(K const& key, size_t hash, int32_t index)
+	{
+		Table* table = current.load(std::memory_order_relaxed);
+		if (table == nullptr || 2 * (entries.size() + 1) > table->mask + 1)
+		{
+			auto grown = std::make_unique<Table>(table == nullptr ? INITIAL_CAPACITY : 2 * (table->mask + 1));
+			for (auto const& entry : entries)
+			{
+				place(*grown, entry.get());
+			}
+			table = grown.get();
+			tables.push_back(std::move(grown));
+			current.store(table, std::memory_order_release);
+		}
+		entries.push_back(std::make_unique<Entry>(hash, key, index));
+		place(*table, entries.back().get());
+	}
+
+public:
+	// region ctor/dtor
+
+	ConcurrentIndexMap() = default;
+
+	ConcurrentIndexMap(ConcurrentIndexMap const&) = delete;
+
+	ConcurrentIndexMap& operator=(ConcurrentIndexMap const&) = delete;
+	// endregion
+
+	/**
+	 * \brief Wait-free lookup of the index of [key].
+	 */
+	optional<int32_t> find(K const& key) const
+	{
+		Entry const* entry = find_entry(current.load(std::memory_order_acquire), key, hasher(key));
+		if (entry == nullptr)
+		{
+			return nullopt;
+		}
+		return entry->index.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * \brief Adds [key] with [index] unless it's present already.
+	 * \return the index [key] has afterwards
+	 */
+	int32_t insert(K const& key, int32_t index)
+	{
+		const size_t hash = hasher(key);
+		std::lock_guard<std::mutex> guard(write_lock);
+		if (Entry const* entry = find_entry(current.load(std::memory_order_relaxed), key, hash))
+		{
+			return entry->index.load(std::memory_order_relaxed);
+		}
+		add(key, hash, index);
+		return index;
+	}
+
+	/**
+	 * \brief Adds [key] with [index] or replaces the index it has.
+	 */
+	void assign(K const& key, int32_t index)
+	{
+		const size_t hash = hasher(key);
+		std::lock_guard<std::mutex> guard(write_lock);
+		if (Entry* entry = find_entry(current.load(std::memory_order_relaxed), key, hash))
+		{
+			entry->index.store(index, std::memory_order_release);
+			return;
+		}
+		add(key, hash, index);
+	}
+
+	/**
+	 * \brief Removes all keys, mustn't be called concurrently with readers.
+	 */
+	void clear()
+	{
+		std::lock_guard<std::mutex> guard(write_lock);
+		current.store(nullptr, std::memory_order_relaxed);
+		tables.clear();
+		entries.clear();
+	}
+};
+}	 // namespace rd
+
+#endif	  // RD_CPP_CONCURRENTINDEXMAP_H
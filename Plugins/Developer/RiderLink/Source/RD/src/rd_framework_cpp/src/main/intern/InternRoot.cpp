@@ -22,7 +22,7 @@ void InternRoot::on_wire_received(Buffer buffer) const
 	{
 		return;
 	}
-	const int32_t remote_id = buffer.read_integral<int32_t>();
+	const int32_t remote_id = buffer.read_varint<int32_t>();
 	set_interned_correspondence(remote_id ^ 1, *std::move(value));
 	RD_ASSERT_MSG(((remote_id & 1) == 0), "Remote sent ID marked as our own, bug?");
 }
@@ -33,22 +33,18 @@ void InternRoot::bind(Lifetime lf, IRdDynamic const* parent, string_view name) c
 
 	lf->bracket(
 		[this, parent, &name] {
-			this->parent = parent;
+			set_parent(parent);
 			location = parent->get_location().sub(name, ".");
 		},
 		[this] {
-			location = location.sub("<<unbound>>", "::");
-			this->parent = nullptr;
+			set_parent(nullptr);
 			rdid = RdId::Null();
 		});
 
-	{
-		// if something's interned before bind
-		std::lock_guard<decltype(lock)> guard(lock);
-		my_items_lis.clear();
-		other_items_list.clear();
-		inverse_map.clear();
-	}
+	// if something's interned before bind
+	my_items_lis.clear();
+	other_items_list.clear();
+	inverse_map.clear();
 	get_protocol()->get_wire()->advise(lf, this);
 }
 
@@ -64,8 +60,11 @@ void InternRoot::set_interned_correspondence(int32_t id, InternedAny&& value) co
 {
 	RD_ASSERT_MSG(!is_index_owned(id), "Setting interned correspondence for object that we should have written, bug?")
 
-	std::lock_guard<decltype(lock)> guard(lock);
-	other_items_list[id / 2] = value;
-	inverse_map[value] = id;
+	if (!other_items_list.set(id / 2, value) && other_items_list.get(id / 2) == nullptr)
+	{
+		spdlog::error("InternRoot: implausible remote id {} is ignored", id);
+		return;
+	}
+	inverse_map.assign(value, id);
 }
 }	 // namespace rd
@@ -3,16 +3,14 @@
 
 #include "base/RdReactiveBase.h"
 #include "InternScheduler.h"
+#include "ConcurrentIndexMap.h"
+#include "SegmentedArray.h"
 #include "lifetime/Lifetime.h"
 #include "types/wrapper.h"
 #include "serialization/RdAny.h"
 #include "util/core_traits.h"
 
-#include "tsl/ordered_map.h"
-
-#include <vector>
 #include <string>
-#include <mutex>
 
 #include <rd_framework_export.h>
 
@@ -36,17 +34,14 @@ class Identities;
 class RD_FRAMEWORK_API InternRoot final : public RdReactiveBase
 {
 private:
-	// template<typename T>
-	mutable std::vector<InternedAny> my_items_lis;
+	// readers don't take any lock, interned values are never removed until the root is bound again
+	mutable SegmentedArray<InternedAny> my_items_lis;
 
-	// template<typename T>
-	mutable ordered_map<int32_t, InternedAny> other_items_list;
-	// template<typename T>
-	mutable ordered_map<InternedAny, int32_t, any::TransparentHash, any::TransparentKeyEqual> inverse_map;
+	mutable SegmentedArray<InternedAny> other_items_list;
 
-	mutable InternScheduler intern_scheduler;
+	mutable ConcurrentIndexMap<InternedAny, any::TransparentHash, any::TransparentKeyEqual> inverse_map;
 
-	mutable std::recursive_mutex lock;
+	mutable InternScheduler intern_scheduler;
 
 	void set_interned_correspondence(int32_t id, InternedAny&& value) const;
 
@@ -95,8 +90,12 @@ constexpr bool InternRoot::is_index_owned(int32_t id)
 template <typename T>
 Wrapper<T> InternRoot::un_intern_value(int32_t id) const
 {
-	// don't need lock because value's already exists and never removes
-	return any::get<T>(is_index_owned(id) ? my_items_lis[id / 2] : other_items_list[id / 2]);
+	InternedAny const* value = is_index_owned(id) ? my_items_lis.get(id / 2) : other_items_list.get(id / 2);
+	if (value == nullptr)
+	{
+		throw std::invalid_argument("Value isn't interned, id: " + std::to_string(id));
+	}
+	return any::get<T>(*value);
 }
 
 template <typename T>
@@ -104,31 +103,21 @@ int32_t InternRoot::intern_value(Wrapper<T> value) const
 {
 	InternedAny any = any::make_interned_any<T>(value);
 
-	std::lock_guard<decltype(lock)> guard(lock);
-
-	auto it = inverse_map.find(any);
-	int32_t index = 0;
-	if (it == inverse_map.end())
+	if (auto index = inverse_map.find(any))
 	{
-		get_protocol()->get_wire()->send(this->rdid, [this, &index, value, any](Buffer& buffer) {
-			InternedAnySerializer::write<T>(get_serialization_context(), buffer, wrapper::get<T>(value));
-			{
-				std::lock_guard<decltype(lock)> guard(lock);
-				index = static_cast<int32_t>(my_items_lis.size()) * 2;
-				my_items_lis.emplace_back(any);
-			}
-			buffer.write_integral<int32_t>(index);
-		});
+		return *index;
 	}
-	else
-	{
-		index = it->second;
-	}
-	if (inverse_map.count(any) == 0)
-	{
-		inverse_map[any] = index;
-	}
-	return index;
+
+	// sent without any lock, threads interning the same value at once send it more than once
+	int32_t index = 0;
+	get_protocol()->get_wire()->send(this->rdid, [this, &index, &value, &any](Buffer& buffer) {
+		InternedAnySerializer::write<T>(get_serialization_context(), buffer, wrapper::get<T>(value));
+		// ids follow the order of the messages
+		index = static_cast<int32_t>(my_items_lis.push_back(any)) * 2;
+		buffer.write_varint<int32_t>(index);
+	});
+	// published once it's sent, so that messages referring to it are sent after it
+	return inverse_map.insert(any, index);
 }
 }	 // namespace rd
 #if defined(_MSC_VER)
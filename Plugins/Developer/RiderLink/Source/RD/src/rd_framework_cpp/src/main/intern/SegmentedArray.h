@@ -0,0 +1,153 @@
+#ifndef RD_CPP_SEGMENTEDARRAY_H
+#define RD_CPP_SEGMENTEDARRAY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+namespace rd
+{
+/**
+ * \brief Array whose slots never move once allocated, so that it's read without any lock while being filled.
+ * Segments double in size, a slot is written once and becomes visible to readers after that.
+ *
+ * \tparam T default constructible type of elements
+ */
+template <typename T>
+class SegmentedArray
+{
+	static constexpr size_t FIRST_SEGMENT_SIZE = 64;
+	// 64 * (2^26 - 1) slots
+	static constexpr size_t MAX_SEGMENTS = 26;
+
+	struct Slot
+	{
+		T value{};
+		std::atomic<bool> ready{false};
+	};
+
+	std::atomic<Slot*> segments[MAX_SEGMENTS] = {};
+	size_t pushed = 0;
+	size_t filled = 0;
+	std::mutex write_lock;
+
+	static size_t segment_of(size_t index, size_t& offset)
+	{
+		const size_t n = index / FIRST_SEGMENT_SIZE + 1;
+		size_t segment = 0;
+		while ((n >> (segment + 1)) != 0)
+		{
+			++segment;
+		}
+		offset = index - FIRST_SEGMENT_SIZE * ((size_t(1) << segment) - 1);
+		return segment;
+	}
+
+	Slot* slot_for_write(size_t index)
+	{
+		size_t offset;
+		const size_t segment = segment_of(index, offset);
+		if (segment >= MAX_SEGMENTS)
+		{
+			return nullptr;
+		}
+		Slot* slots = segments[segment].load(std::memory_order_relaxed);
+		if (slots == nullptr)
+		{
+			slots = new Slot[FIRST_SEGMENT_SIZE << segment];
+			segments[segment].store(slots, std::memory_order_release);
+		}
+		return &slots[offset];
+	}
+
+public:
+	// region ctor/dtor
+
+	SegmentedArray() = default;
+
+	SegmentedArray(SegmentedArray const&) = delete;
+
+	SegmentedArray& operator=(SegmentedArray const&) = delete;
+
+	~SegmentedArray()
+	{
+		clear();
+	}
+	// endregion
+
+	/**
+	 * \brief Wait-free lookup of the element at [index], nullptr if it hasn't been set.
+	 */
+	T const* get(size_t index) const
+	{
+		size_t offset;
+		const size_t segment = segment_of(index, offset);
+		if (segment >= MAX_SEGMENTS)
+		{
+			return nullptr;
+		}
+		Slot const* slots = segments[segment].load(std::memory_order_acquire);
+		if (slots == nullptr || !slots[offset].ready.load(std::memory_order_acquire))
+		{
+			return nullptr;
+		}
+		return &slots[offset].value;
+	}
+
+	/**
+	 * \brief Sets the element at [index] unless it has been set already or [index] is implausibly far
+	 * beyond the elements set so far, which would allocate a huge segment for a few elements.
+	 * \return if the element has been set by this call
+	 */
+	bool set(size_t index, T value)
+	{
+		std::lock_guard<std::mutex> guard(write_lock);
+		if (index >= FIRST_SEGMENT_SIZE + 2 * filled)
+		{
+			return false;
+		}
+		Slot* slot = slot_for_write(index);
+		if (slot == nullptr || slot->ready.load(std::memory_order_relaxed))
+		{
+			return false;
+		}
+		slot->value = std::move(value);
+		slot->ready.store(true, std::memory_order_release);
+		++filled;
+		return true;
+	}
+
+	/**
+	 * \brief Appends [value] after all the elements appended before.
+	 * \return index of the element
+	 */
+	size_t push_back(T value)
+	{
+		std::lock_guard<std::mutex> guard(write_lock);
+		const size_t index = pushed++;
+		++filled;
+		Slot* slot = slot_for_write(index);
+		slot->value = std::move(value);
+		slot->ready.store(true, std::memory_order_release);
+		return index;
+	}
+
+	/**
+	 * \brief Removes all elements, mustn't be called concurrently with readers.
+	 */
+	void clear()
+	{
+		std::lock_guard<std::mutex> guard(write_lock);
+		for (auto& segment : segments)
+		{
+			delete[] segment.exchange(nullptr, std::memory_order_relaxed);
+		}
+		pushed = 0;
+		filled = 0;
+	}
+};
+}	 // namespace rd
+
+#endif	  // RD_CPP_SEGMENTEDARRAY_H
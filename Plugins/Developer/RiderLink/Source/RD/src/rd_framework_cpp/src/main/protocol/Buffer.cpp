@@ -4,6 +4,8 @@
 
 #include <string>
 #include <algorithm>
+#include <cstring>
+#include <stdexcept>
 
 namespace rd
 {
@@ -56,6 +58,45 @@ void Buffer::write(const word_t* src, size_t size)
 	offset += size;
 }
 
+void Buffer::set_varint_integrals(bool value)
+{
+	varint_integrals_ = value;
+}
+
+bool Buffer::varint_integrals() const
+{
+	return varint_integrals_;
+}
+
+uint64_t Buffer::read_varint_tail(uint64_t first, size_t max_length)
+{
+	uint64_t bits = first & 0x7F;
+	for (size_t i = 1; i < max_length; ++i)
+	{
+		check_available(1);
+		const uint64_t next = data_[offset++];
+		bits |= (next & 0x7F) << (7 * i);
+		if (next < 0x80)
+		{
+			return bits;
+		}
+	}
+	throw std::invalid_argument("Varint is longer than " + std::to_string(max_length) + " bytes");
+}
+
+void Buffer::write_varint_tail(uint64_t bits)
+{
+	word_t bytes[10];
+	size_t length = 0;
+	while (bits >= 0x80)
+	{
+		bytes[length++] = static_cast<word_t>(bits | 0x80);
+		bits >>= 7;
+	}
+	bytes[length++] = static_cast<word_t>(bits);
+	write(bytes, length);
+}
+
 void Buffer::require_available(size_t moreSize)
 {
 	if (offset + moreSize >= size())
@@ -141,7 +182,7 @@ std::wstring read_wstring_spec(Buffer& buffer)
 template <>
 std::wstring read_wstring_spec<2>(Buffer& buffer)
 {
-	const int32_t len = buffer.read_integral<int32_t>();
+	const int32_t len = buffer.read_varint<int32_t>();
 	RD_ASSERT_MSG(len >= 0, "read null string(length =" + std::to_string(len) + ")");
 	std::wstring result;
 	result.resize(len);
@@ -149,6 +190,77 @@ std::wstring read_wstring_spec<2>(Buffer& buffer)
 	return result;
 }
 
+static bool is_surrogate(uint32_t c)
+{
+	return (c & 0xFFFFF800u) == 0xD800u;
+}
+
+static uint16_t load_utf16(Buffer::word_t const* src)
+{
+	uint16_t unit;
+	std::memcpy(&unit, src, sizeof(unit));
+	return unit;
+}
+
+static void store_utf16(Buffer::word_t* dst, uint32_t unit)
+{
+	const auto value = static_cast<uint16_t>(unit);
+	std::memcpy(dst, &value, sizeof(value));
+}
+
+// wchar_t is UTF-32 here, wire format is UTF-16: transcode straight from/into buffer's storage
+template <>
+std::wstring read_wstring_spec<4>(Buffer& buffer)
+{
+	const int32_t len = buffer.read_varint<int32_t>();
+	RD_ASSERT_MSG(len >= 0, "read null string(length =" + std::to_string(len) + ")");
+	const size_t byte_len = sizeof(uint16_t) * len;
+	buffer.check_available(byte_len);
+
+	Buffer::word_t const* src = buffer.current_pointer();
+	std::wstring result;
+	result.resize(len);
+	wchar_t* dst = &result[0];
+
+	bool has_surrogates = false;
+	for (int32_t i = 0; i < len; ++i)
+	{
+		has_surrogates |= is_surrogate(load_utf16(src + sizeof(uint16_t) * i));
+	}
+
+	if (!has_surrogates)
+	{
+		// fast path, includes ASCII: every code unit is a code point
+		for (int32_t i = 0; i < len; ++i)
+		{
+			dst[i] = static_cast<wchar_t>(load_utf16(src + sizeof(uint16_t) * i));
+		}
+	}
+	else
+	{
+		size_t n = 0;
+		for (int32_t i = 0; i < len; ++i)
+		{
+			uint32_t c = load_utf16(src + sizeof(uint16_t) * i);
+			if (c >= 0xD800u && c < 0xDC00u && i + 1 < len)
+			{
+				const uint32_t low = load_utf16(src + sizeof(uint16_t) * (i + 1));
+				if (low >= 0xDC00u && low < 0xE000u)
+				{
+					c = 0x10000u + ((c - 0xD800u) << 10) + (low - 0xDC00u);
+					++i;
+				}
+			}
+			// unpaired surrogates are kept as is
+			dst[n++] = static_cast<wchar_t>(c);
+		}
+		result.resize(n);
+	}
+
+	buffer.set_position(buffer.get_position() + byte_len);
+	return result;
+}
+
 std::wstring Buffer::read_wstring()
 {
 	return read_wstring_spec<sizeof(wchar_t)>(*this);
@@ -164,10 +276,58 @@ void write_wstring_spec(Buffer& buffer, wstring_view value)
 template <>
 void write_wstring_spec<2>(Buffer& buffer, wstring_view value)
 {
-	buffer.write_integral<int32_t>(static_cast<int32_t>(value.size()));
+	buffer.write_varint<int32_t>(static_cast<int32_t>(value.size()));
 	buffer.write(reinterpret_cast<Buffer::word_t const*>(value.data()), sizeof(wchar_t) * value.size());
 }
 
+template <>
+void write_wstring_spec<4>(Buffer& buffer, wstring_view value)
+{
+	size_t len = value.size();
+	for (wchar_t c : value)
+	{
+		len += static_cast<uint32_t>(c) > 0xFFFFu && static_cast<uint32_t>(c) <= 0x10FFFFu;
+	}
+
+	buffer.write_varint<int32_t>(static_cast<int32_t>(len));
+	const size_t byte_len = sizeof(uint16_t) * len;
+	buffer.require_available(byte_len);
+	Buffer::word_t* dst = buffer.current_pointer();
+
+	if (len == value.size())
+	{
+		// fast path, includes ASCII: every code point fits one code unit
+		for (size_t i = 0; i < len; ++i)
+		{
+			const auto c = static_cast<uint32_t>(value[i]);
+			store_utf16(dst + sizeof(uint16_t) * i, c <= 0xFFFFu ? c : 0xFFFDu);
+		}
+	}
+	else
+	{
+		size_t n = 0;
+		for (wchar_t ch : value)
+		{
+			const auto c = static_cast<uint32_t>(ch);
+			if (c <= 0xFFFFu)
+			{
+				store_utf16(dst + sizeof(uint16_t) * n++, c);
+			}
+			else if (c <= 0x10FFFFu)
+			{
+				store_utf16(dst + sizeof(uint16_t) * n++, 0xD800u + ((c - 0x10000u) >> 10));
+				store_utf16(dst + sizeof(uint16_t) * n++, 0xDC00u + ((c - 0x10000u) & 0x3FFu));
+			}
+			else
+			{
+				store_utf16(dst + sizeof(uint16_t) * n++, 0xFFFDu);
+			}
+		}
+	}
+
+	buffer.set_position(buffer.get_position() + byte_len);
+}
+
 void Buffer::write_wstring(std::wstring const& value)
 {
 	write_wstring(wstring_view(value));
@@ -175,13 +335,13 @@ void Buffer::write_wstring(std::wstring const& value)
 
 void Buffer::write_char16_string(const uint16_t* data, size_t len)
 {
-	write_integral<int32_t>(static_cast<int32_t>(len));
+	write_varint<int32_t>(static_cast<int32_t>(len));
 	write(reinterpret_cast<word_t const*>(data), sizeof(uint16_t) * len);
 }
 
 uint16_t* Buffer::read_char16_string()
 {	
-	const int32_t len = read_integral<int32_t>();
+	const int32_t len = read_varint<int32_t>();
 	RD_ASSERT_MSG(len >= 0, "read null string(length =" + std::to_string(len) + ")");
 	uint16_t * result = new uint16_t[len+1];
 	read(reinterpret_cast<Buffer::word_t*>(&result[0]), sizeof(uint16_t) * len);
@@ -239,7 +399,7 @@ void Buffer::write_char(wchar_t value)
 
 void Buffer::read_byte_array(ByteArray& array)
 {
-	const int32_t length = read_integral<int32_t>();
+	const int32_t length = read_varint<int32_t>();
 	array.resize(length);
 	read_byte_array_raw(array);
 }
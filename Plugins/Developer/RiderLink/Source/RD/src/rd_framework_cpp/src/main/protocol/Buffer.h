@@ -46,6 +46,8 @@ private:
 
 	size_t offset = 0;
 
+	bool varint_integrals_ = false;
+
 	// read
 	void read(word_t* dst, size_t size);
 
@@ -54,6 +56,10 @@ private:
 
 	size_t size() const;
 
+	uint64_t read_varint_tail(uint64_t first, size_t max_length);
+
+	void write_varint_tail(uint64_t bits);
+
 public:
 	// region ctor/dtor
 
@@ -97,6 +103,62 @@ public:
 		write(reinterpret_cast<word_t const*>(&value), sizeof(T));
 	}
 
+	/**
+	 * \brief If set, integrals of [read_varint] and [write_varint] are LEB128 varints, zigzag encoded when signed.
+	 * Otherwise they are fixed width as [read_integral] and [write_integral] do, which is the format of peers unaware
+	 * of varints. Wires set it per message.
+	 */
+	void set_varint_integrals(bool value);
+
+	bool varint_integrals() const;
+
+	/**
+	 * \brief Reads integral written by [write_varint] in the same mode.
+	 */
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value, T>>
+	T read_varint()
+	{
+		if (!varint_integrals_ || sizeof(T) == 1)
+		{
+			return read_integral<T>();
+		}
+		check_available(1);
+		uint64_t bits = data_[offset++];
+		if (bits >= 0x80)
+		{
+			bits = read_varint_tail(bits, (8 * sizeof(T) + 6) / 7);
+		}
+		if (std::is_signed<T>::value)
+		{
+			return static_cast<T>(static_cast<int64_t>(bits >> 1) ^ -static_cast<int64_t>(bits & 1));
+		}
+		return static_cast<T>(bits);
+	}
+
+	/**
+	 * \brief Writes integral, it takes a single byte in varint mode if it's within [-64, 63] or [0, 127] if unsigned.
+	 * Not for values patched in place later.
+	 */
+	template <typename T, typename = typename std::enable_if_t<std::is_integral<T>::value>>
+	void write_varint(T const& value)
+	{
+		if (!varint_integrals_ || sizeof(T) == 1)
+		{
+			write_integral(value);
+			return;
+		}
+		const uint64_t bits = std::is_signed<T>::value
+								  ? (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(value) >> 63)
+								  : static_cast<uint64_t>(value);
+		if (bits < 0x80)
+		{
+			require_available(1);
+			data_[offset++] = static_cast<word_t>(bits);
+			return;
+		}
+		write_varint_tail(bits);
+	}
+
 	template <typename T, typename = typename std::enable_if_t<std::is_floating_point<T>::value, T>>
 	T read_floating_point()
 	{
@@ -115,7 +177,7 @@ public:
 		typename = typename std::enable_if_t<util::is_pod_v<T>>>
 	C<T, A> read_array()
 	{
-		int32_t len = read_integral<int32_t>();
+		int32_t len = read_varint<int32_t>();
 		RD_ASSERT_MSG(len >= 0, "read null array(length = " + std::to_string(len) + ")");
 		C<T, A> result;
 		using rd::resize;
@@ -130,7 +192,7 @@ public:
 	template <template <class, class> class C, typename T, typename A = allocator<value_or_wrapper<T>>>
 	C<value_or_wrapper<T>, A> read_array(std::function<value_or_wrapper<T>()> reader)
 	{
-		int32_t len = read_integral<int32_t>();
+		int32_t len = read_varint<int32_t>();
 		C<value_or_wrapper<T>, A> result;
 		using rd::resize;
 		resize(result, len);
@@ -147,7 +209,7 @@ public:
 	{
 		using rd::size;
 		const int32_t& len = rd::size(container);
-		write_integral<int32_t>(static_cast<int32_t>(len));
+		write_varint<int32_t>(static_cast<int32_t>(len));
 		if (len > 0)
 		{
 			write(reinterpret_cast<word_t const*>(&container[0]), sizeof(T) * len);
@@ -159,7 +221,7 @@ public:
 	void write_array(C<T, A> const& container, std::function<void(T const&)> writer)
 	{
 		using rd::size;
-		write_integral<int32_t>(size(container));
+		write_varint<int32_t>(static_cast<int32_t>(size(container)));
 		for (auto const& e : container)
 		{
 			writer(e);
@@ -170,7 +232,7 @@ public:
 	void write_array(C<Wrapper<T>, A> const& container, std::function<void(T const&)> writer)
 	{
 		using rd::size;
-		write_integral<int32_t>(size(container));
+		write_varint<int32_t>(static_cast<int32_t>(size(container)));
 		for (auto const& e : container)
 		{
 			writer(*e);
@@ -214,27 +276,27 @@ public:
 	template <typename T, typename = typename std::enable_if_t<util::is_enum_v<T>>>
 	T read_enum()
 	{
-		int32_t x = read_integral<int32_t>();
+		int32_t x = read_varint<int32_t>();
 		return static_cast<T>(x);
 	}
 
 	template <typename T, typename = typename std::enable_if_t<util::is_enum_v<T>>>
 	void write_enum(T const& x)
 	{
-		write_integral<int32_t>(static_cast<int32_t>(x));
+		write_varint<int32_t>(static_cast<int32_t>(x));
 	}
 
 	template <typename T, typename = typename std::enable_if_t<util::is_enum_v<T>>>
 	T read_enum_set()
 	{
-		int32_t x = read_integral<int32_t>();
+		int32_t x = read_varint<int32_t>();
 		return static_cast<T>(x);
 	}
 
 	template <typename T, typename = typename std::enable_if_t<util::is_enum_v<T>>>
 	void write_enum_set(T const& x)
 	{
-		write_integral<int32_t>(static_cast<int32_t>(x));
+		write_varint<int32_t>(static_cast<int32_t>(x));
 	}
 
 	template <typename T, typename F, typename = typename std::enable_if_t<util::is_same_v<typename util::result_of_t<F()>, T>>>
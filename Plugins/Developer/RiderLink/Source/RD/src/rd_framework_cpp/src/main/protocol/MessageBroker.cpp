@@ -8,12 +8,180 @@ namespace rd
 std::shared_ptr<spdlog::logger> MessageBroker::logger =
 	spdlog::stderr_color_mt<spdlog::synchronous_factory>("logger", spdlog::color_mode::automatic);
 
+constexpr size_t MessageBroker::SHARDS;
+
 static void execute(const IRdReactive* that, Buffer msg)
 {
 	msg.read_integral<int16_t>();	   // skip context
 	that->on_wire_received(std::move(msg));
 }
 
+MessageBroker::Shard& MessageBroker::shard_of(RdId id) const
+{
+	return shards[static_cast<uint64_t>(id.get_hash()) % SHARDS];
+}
+
+RdReactiveBase const* MessageBroker::find_subscription(RdId id) const
+{
+	Shard& shard = shard_of(id);
+	std::lock_guard<decltype(shard.lock)> guard(shard.lock);
+	auto it = shard.subscriptions.find(id);
+	return it != shard.subscriptions.end() ? it->second.entity : nullptr;
+}
+
+void MessageBroker::set_pending(RdId id, bool pending) const
+{
+	Shard& shard = shard_of(id);
+	std::lock_guard<decltype(shard.lock)> guard(shard.lock);
+	auto it = shard.subscriptions.find(id);
+	if (it != shard.subscriptions.end())
+	{
+		it->second.pending = pending;
+	}
+}
+
+MessageBroker::Inbox* MessageBroker::subscribe_inbox(IScheduler* scheduler) const
+{
+	std::lock_guard<decltype(inboxes_lock)> guard(inboxes_lock);
+	auto& inbox = inboxes[scheduler->instance_id];
+	if (inbox == nullptr)
+	{
+		inbox = new Inbox(scheduler);
+	}
+	++inbox->subscriptions;
+	return inbox;
+}
+
+void MessageBroker::unsubscribe_inbox(Inbox* inbox) const
+{
+	{
+		std::lock_guard<decltype(inboxes_lock)> guard(inboxes_lock);
+		if (--inbox->subscriptions > 0)
+		{
+			return;
+		}
+		inboxes.erase(inbox->scheduler_id);
+	}
+	release(*inbox);
+}
+
+void MessageBroker::retain(Inbox& inbox)
+{
+	inbox.refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MessageBroker::release(Inbox& inbox)
+{
+	if (inbox.refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		delete &inbox;
+	}
+}
+
+bool MessageBroker::try_post(RdId id, Buffer& message) const
+{
+	Shard& shard = shard_of(id);
+	Inbox* inbox;
+	RdReactiveBase const* entity;
+	{
+		std::lock_guard<decltype(shard.lock)> guard(shard.lock);
+		auto it = shard.subscriptions.find(id);
+		if (it == shard.subscriptions.end() || it->second.pending)
+		{
+			return false;
+		}
+		Subscription& subscription = it->second;
+		entity = subscription.entity;
+		// wire scheduler may be changed after binding, e.g. by RdSignal::advise_on
+		IScheduler* scheduler = entity->get_wire_scheduler();
+		if (subscription.inbox == nullptr || subscription.inbox->scheduler_id != scheduler->instance_id)
+		{
+			if (subscription.inbox != nullptr)
+			{
+				unsubscribe_inbox(subscription.inbox);
+			}
+			subscription.inbox = subscribe_inbox(scheduler);
+		}
+		inbox = subscription.inbox;
+		// the subscription may be terminated while posting
+		retain(*inbox);
+	}
+	post(*inbox, id, entity, std::move(message));
+	release(*inbox);
+	return true;
+}
+
+void MessageBroker::post(Inbox& inbox, RdId id, RdReactiveBase const* entity, Buffer message) const
+{
+	if (inbox.scheduler->out_of_order_execution)
+	{
+		// handlers may run in parallel, a batch would serialize them
+		auto action = [this, message = Inbox::Message{id, entity, std::move(message)}]() mutable { execute_checked(message); };
+		std::function<void()> function = util::make_shared_function(std::move(action));
+		inbox.scheduler->queue(std::move(function));
+		return;
+	}
+
+	{
+		std::lock_guard<decltype(inbox.lock)> guard(inbox.lock);
+		inbox.messages.push_back(Inbox::Message{id, entity, std::move(message)});
+		if (inbox.scheduled)
+		{
+			return;
+		}
+		inbox.scheduled = true;
+	}
+	retain(inbox);
+	// captures fit into std::function's small buffer, so queueing doesn't allocate
+	inbox.scheduler->queue([this, &inbox]() { execute_batch(inbox); });
+}
+
+void MessageBroker::execute_checked(Inbox::Message& message) const
+{
+	if (find_subscription(message.id) != message.entity)
+	{
+		logger->trace("Disappeared Handler for Reactive entities with id: {}", to_string(message.id));
+		return;
+	}
+	execute(message.entity, std::move(message.buffer));
+}
+
+void MessageBroker::execute_batch(Inbox& inbox) const
+{
+	{
+		std::lock_guard<decltype(inbox.lock)> guard(inbox.lock);
+		std::swap(inbox.messages, inbox.executing);
+	}
+
+	for (auto& message : inbox.executing)
+	{
+		try
+		{
+			execute_checked(message);
+		}
+		catch (std::exception const& e)
+		{
+			logger->error("Handler for id: {} failed | {}", to_string(message.id), e.what());
+		}
+	}
+	inbox.executing.clear();
+
+	bool done;
+	{
+		std::lock_guard<decltype(inbox.lock)> guard(inbox.lock);
+		done = inbox.messages.empty();
+		inbox.scheduled = !done;
+	}
+	if (done)
+	{
+		// the inbox may be deleted here if its subscriptions have gone
+		release(inbox);
+		return;
+	}
+	// let other tasks of the scheduler run between batches
+	inbox.scheduler->queue([this, &inbox]() { execute_batch(inbox); });
+}
+
 void MessageBroker::invoke(const RdReactiveBase* that, Buffer msg, bool sync) const
 {
 	if (sync)
@@ -22,110 +190,112 @@ void MessageBroker::invoke(const RdReactiveBase* that, Buffer msg, bool sync) co
 	}
 	else
 	{
-		auto action = [this, that, message = std::move(msg)]() mutable {
-			bool exists_id = false;
+		Inbox* inbox = subscribe_inbox(that->get_wire_scheduler());
+		post(*inbox, that->get_id(), that, std::move(msg));
+		unsubscribe_inbox(inbox);
+	}
+}
+
+MessageBroker::MessageBroker(IScheduler* defaultScheduler) : default_scheduler(defaultScheduler)
+{
+}
+
+MessageBroker::~MessageBroker()
+{
+	for (auto& it : inboxes)
+	{
+		release(*it.second);
+	}
+}
+
+void MessageBroker::queue_to_broker(RdId id, Buffer message) const
+{
+	auto it = broker.find(id);
+	if (it == broker.end())
+	{
+		it = broker.emplace(id, Mq{}).first;
+	}
+
+	it->second.default_scheduler_messages.emplace(std::move(message));
+
+	auto action = [this, id]() mutable {
+		RdReactiveBase const* subscription = find_subscription(id);
+
+		optional<Buffer> message;
+		std::vector<Buffer> custom_scheduler_messages;
+		{
+			std::lock_guard<decltype(lock)> guard(lock);
+			auto& current = broker.at(id);
+			if (!current.default_scheduler_messages.empty())
 			{
-				std::lock_guard<decltype(lock)> guard(lock);
-				exists_id = subscriptions.count(that->get_id()) > 0;
+				message = make_optional<Buffer>(std::move(current.default_scheduler_messages.front()));
+				current.default_scheduler_messages.pop();
 			}
-			if (exists_id)
+			if (current.default_scheduler_messages.empty())
 			{
-				execute(that, std::move(message));
+				custom_scheduler_messages = std::move(current.custom_scheduler_messages);
+				broker.erase(id);
+				set_pending(id, false);
 			}
-			else
+		}
+		if (subscription != nullptr)
+		{
+			if (message)
 			{
-				logger->trace("Disappeared Handler for Reactive entities with id: {}", to_string(that->get_id()));
+				invoke(subscription, *std::move(message), subscription->get_wire_scheduler() == default_scheduler);
 			}
-		};
-		std::function<void()> function = util::make_shared_function(std::move(action));
-		that->get_wire_scheduler()->queue(std::move(function));
-	}
-}
+		}
+		else
+		{
+			logger->trace("No handler for id: {}", to_string(id));
+		}
 
-MessageBroker::MessageBroker(IScheduler* defaultScheduler) : default_scheduler(defaultScheduler)
-{
+		for (auto& it : custom_scheduler_messages)
+		{
+			RD_ASSERT_MSG(subscription->get_wire_scheduler() != default_scheduler,
+				"require equals of wire and default schedulers")
+			invoke(subscription, std::move(it));
+		}
+	};
+	std::function<void()> function = util::make_shared_function(std::move(action));
+	default_scheduler->queue(std::move(function));
 }
 
 void MessageBroker::dispatch(RdId id, Buffer message) const
 {
 	RD_ASSERT_MSG(!id.isNull(), "id mustn't be null")
 
+	if (try_post(id, message))
+	{
+		return;
+	}
+
 	{	 // synchronized recursively
 		std::lock_guard<decltype(lock)> guard(lock);
-		RdReactiveBase const* s = subscriptions[id];
+		RdReactiveBase const* s = find_subscription(id);
 		if (s == nullptr)
 		{
-			auto it = broker.find(id);
-			if (it == broker.end())
-			{
-				it = broker.emplace(id, Mq{}).first;
-			}
-
-			broker[id].default_scheduler_messages.emplace(std::move(message));
-
-			auto action = [this, it, id]() mutable {
-				auto& current = it->second;
-				RdReactiveBase const* subscription = subscriptions[id];
-
-				optional<Buffer> message;
-				{
-					std::lock_guard<decltype(lock)> guard(lock);
-					if (!current.default_scheduler_messages.empty())
-					{
-						message = make_optional<Buffer>(std::move(current.default_scheduler_messages.front()));
-						current.default_scheduler_messages.pop();
-					}
-				}
-				if (subscription != nullptr)
-				{
-					if (message)
-					{
-						invoke(subscription, *std::move(message), subscription->get_wire_scheduler() == default_scheduler);
-					}
-				}
-				else
-				{
-					logger->trace("No handler for id: {}", to_string(id));
-				}
-
-				if (current.default_scheduler_messages.empty())
-				{
-					auto t = std::move(broker[id]);
-					broker.erase(id);
-					for (auto& it : t.custom_scheduler_messages)
-					{
-						RD_ASSERT_MSG(subscription->get_wire_scheduler() != default_scheduler,
-							"require equals of wire and default schedulers")
-						invoke(subscription, std::move(it));
-					}
-				}
-			};
-			std::function<void()> function = util::make_shared_function(std::move(action));
-			default_scheduler->queue(std::move(function));
+			queue_to_broker(id, std::move(message));
 		}
 		else
 		{
-			if (s->get_wire_scheduler() == default_scheduler || s->get_wire_scheduler()->out_of_order_execution)
+			auto it = broker.find(id);
+			if (it == broker.end() || s->get_wire_scheduler()->out_of_order_execution)
 			{
 				invoke(s, std::move(message));
 			}
+			else if (s->get_wire_scheduler() == default_scheduler)
+			{
+				// messages received before subscription are still queued, an inbox batch could overtake them
+				queue_to_broker(id, std::move(message));
+			}
 			else
 			{
-				auto it = broker.find(id);
-				if (it == broker.end())
-				{
-					invoke(s, std::move(message));
-				}
-				else
-				{
-					Mq& mq = it->second;
-					mq.custom_scheduler_messages.push_back(std::move(message));
-				}
+				Mq& mq = it->second;
+				mq.custom_scheduler_messages.push_back(std::move(message));
 			}
 		}
 	}
-
-	//        }
 }
 
 void MessageBroker::advise_on(Lifetime lifetime, RdReactiveBase const* entity) const
@@ -139,8 +309,27 @@ void MessageBroker::advise_on(Lifetime lifetime, RdReactiveBase const* entity) c
 	if (!lifetime->is_terminated())
 	{
 		auto key = entity->get_id();
-		subscriptions[key] = entity;
-		lifetime->add_action([this, key]() { subscriptions.erase(key); });
+		{
+			Shard& shard = shard_of(key);
+			std::lock_guard<decltype(shard.lock)> shard_guard(shard.lock);
+			Subscription& subscription = shard.subscriptions[key];
+			subscription.entity = entity;
+			subscription.pending = broker.count(key) > 0;
+		}
+		lifetime->add_action([this, key, entity]() {
+			Shard& shard = shard_of(key);
+			std::lock_guard<decltype(shard.lock)> shard_guard(shard.lock);
+			auto it = shard.subscriptions.find(key);
+			if (it != shard.subscriptions.end() && it->second.entity == entity)
+			{
+				Inbox* inbox = it->second.inbox;
+				shard.subscriptions.erase(it);
+				if (inbox != nullptr)
+				{
+					unsubscribe_inbox(inbox);
+				}
+			}
+		});
 	}
 }
 }	 // namespace rd
@@ -8,11 +8,17 @@
 
 #include "base/IRdReactive.h"
 
+#include "std/flat_hash_map.h"
 #include "std/unordered_map.h"
 
 #include "spdlog/spdlog.h"
 
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <queue>
+#include <vector>
 
 #include <rd_framework_export.h>
 
@@ -43,20 +49,104 @@ public:
 class RD_FRAMEWORK_API MessageBroker final
 {
 private:
+	static constexpr size_t SHARDS = 16;
+
+	/**
+	 * \brief Messages for the entities whose wire scheduler is [scheduler], in the order of arrival.
+	 * They are executed in batches by a single task queued on [scheduler] at a time, unless the scheduler
+	 * has [IScheduler::out_of_order_execution] and gets a task per message.
+	 * Stays in [inboxes] while subscriptions use it and is deleted once the queued task and posting threads are done.
+	 */
+	struct Inbox
+	{
+		struct Message
+		{
+			RdId id;
+			RdReactiveBase const* entity;
+			Buffer buffer;
+		};
+
+		explicit Inbox(IScheduler* scheduler) : scheduler(scheduler), scheduler_id(scheduler->instance_id)
+		{
+		}
+
+		IScheduler* const scheduler;
+		uint64_t const scheduler_id;
+
+		// guarded by [inboxes_lock]
+		size_t subscriptions = 0;
+		// one for [inboxes], one for the queued task and one per message being posted
+		std::atomic<size_t> refs{1};
+
+		std::mutex lock;
+		std::vector<Message> messages;
+		bool scheduled = false;
+
+		// only touched by the queued task, keeps its capacity between batches
+		std::vector<Message> executing;
+	};
+
+	struct Subscription
+	{
+		RdReactiveBase const* entity = nullptr;
+		Inbox* inbox = nullptr;
+		// messages received before subscription are still queued in [broker]
+		bool pending = false;
+	};
+
+	struct Shard
+	{
+		std::mutex lock;
+		rd::flat_hash_map<RdId, Subscription> subscriptions;
+	};
+
 	IScheduler* default_scheduler = nullptr;
-	mutable rd::unordered_map<RdId, RdReactiveBase const*> subscriptions;
-	mutable rd::unordered_map<RdId, Mq> broker;
+	mutable std::array<Shard, SHARDS> shards;
+	mutable rd::flat_hash_map<RdId, Mq> broker;
+
+	mutable std::mutex inboxes_lock;
+	// keyed by [IScheduler::instance_id], so a scheduler allocated at the address of a destroyed one gets a new inbox
+	mutable rd::unordered_map<uint64_t, Inbox*> inboxes;
 
 	mutable std::recursive_mutex lock;
 
 	static std::shared_ptr<spdlog::logger> logger;
 
+	Shard& shard_of(RdId id) const;
+
+	RdReactiveBase const* find_subscription(RdId id) const;
+
+	void set_pending(RdId id, bool pending) const;
+
+	Inbox* subscribe_inbox(IScheduler* scheduler) const;
+
+	void unsubscribe_inbox(Inbox* inbox) const;
+
+	static void retain(Inbox& inbox);
+
+	static void release(Inbox& inbox);
+
+	bool try_post(RdId id, Buffer& message) const;
+
+	void post(Inbox& inbox, RdId id, RdReactiveBase const* entity, Buffer message) const;
+
+	void execute_checked(Inbox::Message& message) const;
+
+	void execute_batch(Inbox& inbox) const;
+
 	void invoke(const RdReactiveBase* that, Buffer msg, bool sync = false) const;
 
+	/**
+	 * \brief Keeps [message] in [broker] until it's taken by a task queued on the default scheduler, called under [lock].
+	 */
+	void queue_to_broker(RdId id, Buffer message) const;
+
 public:
 	// region ctor/dtor
 
 	explicit MessageBroker(IScheduler* defaultScheduler);
+
+	~MessageBroker();
 	// endregion
 
 	void dispatch(RdId id, Buffer message) const;
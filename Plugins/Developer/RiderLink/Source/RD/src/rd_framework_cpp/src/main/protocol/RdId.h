@@ -39,9 +39,16 @@ private:
 	hash_t hash{NULL_ID};
 
 public:
-	friend bool RD_FRAMEWORK_API operator==(RdId const& left, RdId const& right);
+	// inline, ids are compared on every lookup of the message broker and serializers
+	friend constexpr bool operator==(RdId const& left, RdId const& right)
+	{
+		return left.hash == right.hash;
+	}
 
-	friend bool RD_FRAMEWORK_API operator!=(const RdId& lhs, const RdId& rhs);
+	friend constexpr bool operator!=(const RdId& lhs, const RdId& rhs)
+	{
+		return !(rhs == lhs);
+	}
 
 	// region ctor/dtor
 	constexpr RdId() = default;
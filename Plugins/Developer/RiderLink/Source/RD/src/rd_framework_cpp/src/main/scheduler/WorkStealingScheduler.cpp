@@ -0,0 +1,371 @@
+#include "WorkStealingScheduler.h"
+
+#include "util/core_util.h"
+#include "util/thread_util.h"
+
+#include "spdlog/sinks/stdout_color_sinks.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace rd
+{
+static thread_local WorkStealingScheduler const* WorkStealingScheduler_current = nullptr;
+static thread_local size_t WorkStealingScheduler_index = 0;
+static thread_local SerialScheduler const* SerialScheduler_current = nullptr;
+
+// region WorkStealingScheduler
+
+WorkStealingScheduler::WorkStealingScheduler(Lifetime lifetime, std::string name, size_t threads)
+	: log(spdlog::stderr_color_mt<spdlog::synchronous_factory>(name, spdlog::color_mode::automatic))
+	, name(std::move(name))
+	, lifetime(lifetime)
+{
+	out_of_order_execution = true;
+
+	threads = (std::max)(threads, static_cast<size_t>(1));
+	workers.reserve(threads);
+	for (size_t i = 0; i < threads; ++i)
+	{
+		workers.push_back(std::make_unique<Worker>());
+	}
+	// all deques exist before any worker may try to steal from them
+	for (size_t i = 0; i < threads; ++i)
+	{
+		workers[i]->thread = std::thread([this, i] { run(i); });
+	}
+
+	lifetime->add_action([this]() { stop(); });
+}
+
+WorkStealingScheduler::~WorkStealingScheduler()
+{
+	RD_ASSERT_MSG(!is_active(), "Scheduler can't be destroyed by its own action: the worker would outlive it");
+
+	stop();
+
+	Task* task = injected.exchange(nullptr);
+	while (task != nullptr)
+	{
+		delete std::exchange(task, task->next);
+	}
+}
+
+void WorkStealingScheduler::queue(std::function<void()> action)
+{
+	if (!try_queue(std::move(action)))
+	{
+		log->warn("Action is queued after {} was stopped, it won't be executed", name);
+	}
+}
+
+bool WorkStealingScheduler::try_queue(std::function<void()> action)
+{
+	// counted before [stopped] is checked, so the workers don't exit until the action is taken
+	tasks_executing.increment();
+	++tasks_pending;
+	if (stopped)
+	{
+		--tasks_pending;
+		tasks_executing.decrement();
+		return false;
+	}
+
+	if (WorkStealingScheduler_current == this)
+	{
+		Worker& own = *workers[WorkStealingScheduler_index];
+		std::lock_guard<std::mutex> guard(own.lock);
+		own.tasks.push_back(std::move(action));
+	}
+	else
+	{
+		auto task = new Task{std::move(action)};
+		task->next = injected.load(std::memory_order_relaxed);
+		while (!injected.compare_exchange_weak(task->next, task, std::memory_order_release, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	if (sleeping > 0)
+	{
+		std::lock_guard<std::mutex> guard(sleep_lock);
+		sleep_cv.notify_one();
+	}
+	return true;
+}
+
+void WorkStealingScheduler::flush()
+{
+	RD_ASSERT_MSG(!is_active(), "Can't flush this scheduler in a reentrant way: we are inside queued item's execution");
+
+	tasks_executing.wait_for_zero();
+}
+
+bool WorkStealingScheduler::is_active() const
+{
+	return WorkStealingScheduler_current == this;
+}
+
+void WorkStealingScheduler::assert_thread() const
+{
+	if (!is_active())
+	{
+		log->error("Illegal scheduler for current action. Must be a thread of {}", name);
+	}
+}
+
+bool WorkStealingScheduler::is_stopped() const
+{
+	return stopped;
+}
+
+size_t WorkStealingScheduler::get_threads_count() const
+{
+	return workers.size();
+}
+
+void WorkStealingScheduler::run(size_t index)
+{
+	util::set_thread_name(fmt::format("{} {}", name, index).c_str());
+	WorkStealingScheduler_current = this;
+	WorkStealingScheduler_index = index;
+
+	std::function<void()> action;
+	while (true)
+	{
+		if (take(index, action))
+		{
+			execute(action);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> guard(sleep_lock);
+		++sleeping;
+		// checked under sleep_lock after announcing the sleep, so a concurrent queue() either is seen here or notifies
+		sleep_cv.wait(guard, [this] { return tasks_pending != 0 || stopped; });
+		--sleeping;
+		if (tasks_pending == 0 && stopped)
+		{
+			break;
+		}
+	}
+}
+
+bool WorkStealingScheduler::take(size_t index, std::function<void()>& action)
+{
+	Worker& own = *workers[index];
+	{
+		std::lock_guard<std::mutex> guard(own.lock);
+		if (!own.tasks.empty())
+		{
+			action = std::move(own.tasks.front());
+			own.tasks.pop_front();
+			--tasks_pending;
+			return true;
+		}
+	}
+
+	if (take_injected(own, action))
+	{
+		--tasks_pending;
+		return true;
+	}
+
+	for (size_t i = 1; i < workers.size(); ++i)
+	{
+		Worker& victim = *workers[(index + i) % workers.size()];
+		std::lock_guard<std::mutex> guard(victim.lock);
+		if (!victim.tasks.empty())
+		{
+			// steal the newest one, the owner works from the oldest
+			action = std::move(victim.tasks.back());
+			victim.tasks.pop_back();
+			--tasks_pending;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool WorkStealingScheduler::take_injected(Worker& worker, std::function<void()>& action)
+{
+	Task* task = injected.exchange(nullptr, std::memory_order_acquire);
+	if (task == nullptr)
+	{
+		return false;
+	}
+
+	// the stack holds the newest action first
+	Task* reversed = nullptr;
+	while (task != nullptr)
+	{
+		Task* next = task->next;
+		task->next = reversed;
+		reversed = task;
+		task = next;
+	}
+
+	// the oldest one is executed right away, the rest may be stolen as soon as they are in the deque
+	action = std::move(reversed->action);
+	delete std::exchange(reversed, reversed->next);
+
+	std::lock_guard<std::mutex> guard(worker.lock);
+	while (reversed != nullptr)
+	{
+		worker.tasks.push_back(std::move(reversed->action));
+		delete std::exchange(reversed, reversed->next);
+	}
+	return true;
+}
+
+void WorkStealingScheduler::execute(std::function<void()>& action)
+{
+	try
+	{
+		action();
+	}
+	catch (std::exception const& e)
+	{
+		log->error("Background task failed, scheduler={} | {}", name, e.what());
+	}
+	action = nullptr;
+	tasks_executing.decrement();
+}
+
+void WorkStealingScheduler::stop()
+{
+	{
+		std::lock_guard<std::mutex> guard(sleep_lock);
+		stopped = true;
+	}
+	sleep_cv.notify_all();
+
+	if (is_active())
+	{
+		// a worker can't join itself, all of them are joined by the destructor which can't run on a worker
+		log->info("{} is stopped by its own action, workers are joined on destruction", name);
+		return;
+	}
+
+	// workers finish the actions queued so far before exiting
+	std::lock_guard<std::mutex> guard(join_lock);
+	for (auto const& worker : workers)
+	{
+		if (worker->thread.joinable())
+		{
+			worker->thread.join();
+		}
+	}
+}
+
+// endregion
+
+// region SerialScheduler
+
+SerialScheduler::SerialScheduler(WorkStealingScheduler& pool) : pool(pool)
+{
+}
+
+SerialScheduler::~SerialScheduler()
+{
+	RD_ASSERT_MSG(!is_active(), "Scheduler can't be destroyed by its own action: the batch would outlive it");
+
+	wait_idle();
+}
+
+void SerialScheduler::wait_idle()
+{
+	std::unique_lock<std::mutex> guard(lock);
+	// the batch either runs to the end or is dropped by schedule(), both reset [scheduled]
+	idle_cv.wait(guard, [this] { return !scheduled; });
+}
+
+void SerialScheduler::queue(std::function<void()> action)
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		actions.push_back(std::move(action));
+		if (scheduled)
+		{
+			return;
+		}
+		scheduled = true;
+	}
+	schedule();
+}
+
+void SerialScheduler::schedule()
+{
+	if (pool.try_queue([this] { run(); }))
+	{
+		return;
+	}
+
+	std::vector<std::function<void()>> dropped;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		std::swap(actions, dropped);
+		scheduled = false;
+		idle_cv.notify_all();
+	}
+	// [this] may be destroyed already, the actions are released outside of the lock as they may queue others
+	spdlog::warn("SerialScheduler: {} actions are dropped, the pool is stopped", dropped.size());
+}
+
+void SerialScheduler::run()
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		std::swap(actions, executing);
+	}
+
+	auto previous = std::exchange(SerialScheduler_current, this);
+	for (auto& action : executing)
+	{
+		try
+		{
+			action();
+		}
+		catch (std::exception const& e)
+		{
+			spdlog::error("SerialScheduler: action failed | {}", e.what());
+		}
+	}
+	SerialScheduler_current = previous;
+	executing.clear();
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (actions.empty())
+		{
+			scheduled = false;
+			idle_cv.notify_all();
+			return;
+		}
+	}
+	// let other serial schedulers of the pool run between batches
+	schedule();
+}
+
+void SerialScheduler::flush()
+{
+	RD_ASSERT_MSG(!is_active(), "Can't flush this scheduler in a reentrant way: we are inside queued item's execution");
+
+	wait_idle();
+}
+
+bool SerialScheduler::is_active() const
+{
+	return SerialScheduler_current == this;
+}
+
+void SerialScheduler::assert_thread() const
+{
+	if (!is_active())
+	{
+		spdlog::error("Illegal scheduler for current action. Must be a serial scheduler");
+	}
+}
+
+// endregion
+}	 // namespace rd
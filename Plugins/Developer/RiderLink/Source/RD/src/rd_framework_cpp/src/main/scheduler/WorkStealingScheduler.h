@@ -0,0 +1,178 @@
+#ifndef RD_CPP_WORKSTEALINGSCHEDULER_H
+#define RD_CPP_WORKSTEALINGSCHEDULER_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "scheduler/base/IScheduler.h"
+#include "lifetime/Lifetime.h"
+#include "spdlog/spdlog.h"
+#include "util/completion.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Pool of threads executing queued actions in any order and in parallel, hence [out_of_order_execution].
+ * Actions queued from outside of the pool go to a lock-free injection queue, actions queued by the workers
+ * themselves go to their own deque. Idle workers steal from the deques of the others.
+ *
+ * Entities which need their messages handled one at a time should use a [SerialScheduler] on top of it.
+ */
+class RD_FRAMEWORK_API WorkStealingScheduler : public IScheduler
+{
+	struct Task
+	{
+		std::function<void()> action;
+		Task* next = nullptr;
+	};
+
+	struct Worker
+	{
+		std::mutex lock;
+		std::deque<std::function<void()>> tasks;
+		std::thread thread;
+	};
+
+	std::shared_ptr<spdlog::logger> log;
+	std::string name;
+
+	std::vector<std::unique_ptr<Worker>> workers;
+
+	// stack of actions queued from outside, taken as a whole by a worker
+	std::atomic<Task*> injected{nullptr};
+
+	// queued, not yet started
+	std::atomic<uint32_t> tasks_pending{0};
+	// queued, not yet finished
+	util::pending_counter tasks_executing;
+
+	std::mutex sleep_lock;
+	std::condition_variable sleep_cv;
+	std::atomic<uint32_t> sleeping{0};
+	std::atomic<bool> stopped{false};
+	std::mutex join_lock;
+
+	void run(size_t index);
+
+	bool take(size_t index, std::function<void()>& action);
+
+	bool take_injected(Worker& worker, std::function<void()>& action);
+
+	void execute(std::function<void()>& action);
+
+	/**
+	 * \brief Lets the workers exit once the queued actions are done and joins them, unless it's called by one of them.
+	 */
+	void stop();
+
+public:
+	Lifetime lifetime;
+
+	// region ctor/dtor
+
+	WorkStealingScheduler(Lifetime lifetime, std::string name, size_t threads = std::thread::hardware_concurrency());
+
+	WorkStealingScheduler(WorkStealingScheduler const&) = delete;
+
+	WorkStealingScheduler& operator=(WorkStealingScheduler const&) = delete;
+
+	virtual ~WorkStealingScheduler();
+	// endregion
+
+	void queue(std::function<void()> action) override;
+
+	/**
+	 * \brief Queues [action] unless the scheduler is stopped.
+	 *
+	 * \return false if [action] was dropped because the scheduler is stopped.
+	 */
+	bool try_queue(std::function<void()> action);
+
+	/**
+	 * \brief Waits until all queued actions, including those they queue, are finished.
+	 */
+	void flush() override;
+
+	/**
+	 * \brief True on any thread of the pool.
+	 */
+	bool is_active() const override;
+
+	void assert_thread() const override;
+
+	bool is_stopped() const;
+
+	size_t get_threads_count() const;
+};
+
+/**
+ * \brief Executes actions one at a time and in the order they were queued, on the threads of [pool].
+ * Different serial schedulers of the same pool run in parallel, so an entity with its own serial scheduler
+ * keeps its handlers ordered without blocking the others.
+ */
+class RD_FRAMEWORK_API SerialScheduler : public IScheduler
+{
+	WorkStealingScheduler& pool;
+
+	mutable std::mutex lock;
+	std::condition_variable idle_cv;
+	std::vector<std::function<void()>> actions;
+	bool scheduled = false;
+
+	// only touched by the task queued on the pool, keeps its capacity between batches
+	std::vector<std::function<void()>> executing;
+
+	void run();
+
+	/**
+	 * \brief Queues [run] on the pool, the pending actions are dropped if the pool is stopped.
+	 */
+	void schedule();
+
+	void wait_idle();
+
+public:
+	// region ctor/dtor
+
+	explicit SerialScheduler(WorkStealingScheduler& pool);
+
+	SerialScheduler(SerialScheduler const&) = delete;
+
+	SerialScheduler& operator=(SerialScheduler const&) = delete;
+
+	/**
+	 * \brief Waits until the queued actions are executed or dropped by the stopped pool.
+	 */
+	virtual ~SerialScheduler();
+	// endregion
+
+	void queue(std::function<void()> action) override;
+
+	void flush() override;
+
+	/**
+	 * \brief True while one of the actions of this scheduler is executed on the current thread.
+	 */
+	bool is_active() const override;
+
+	void assert_thread() const override;
+};
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_WORKSTEALINGSCHEDULER_H
@@ -2,11 +2,18 @@
 
 #include "spdlog/spdlog.h"
 
+#include <atomic>
 #include <functional>
 #include <sstream>
 
 namespace rd
 {
+uint64_t IScheduler::next_instance_id()
+{
+	static std::atomic<uint64_t> next_id{0};
+	return next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
 void IScheduler::assert_thread() const
 {
 	if (!is_active())
@@ -6,6 +6,7 @@
 #pragma warning(disable:4251)
 #endif
 
+#include <cstdint>
 #include <functional>
 #include <thread>
 
@@ -18,6 +19,9 @@ namespace rd
  */
 class RD_FRAMEWORK_API IScheduler
 {
+private:
+	static uint64_t next_instance_id();
+
 protected:
 	std::thread::id thread_id;
 
@@ -39,6 +43,11 @@ public:
 	// TO-DO
 	bool out_of_order_execution = false;
 
+	/**
+	 * \brief Unique among the schedulers of the process, unlike addresses which are reused after destruction.
+	 */
+	uint64_t const instance_id = next_instance_id();
+
 	virtual void assert_thread() const;
 
 	/**
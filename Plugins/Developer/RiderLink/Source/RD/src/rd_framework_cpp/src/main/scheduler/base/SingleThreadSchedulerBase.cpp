@@ -17,12 +17,12 @@ void SingleThreadSchedulerBase::PoolTask::operator()(int id) const
 	try
 	{
 		f();
-		--scheduler->tasks_executing;
+		scheduler->tasks_executing.decrement();
 	}
 	catch (std::exception const& e)
 	{
 		scheduler->log->error("Background task failed, scheduler={}, thread_id={} | {}", scheduler->name, id, e.what());
-		--scheduler->tasks_executing;
+		scheduler->tasks_executing.decrement();
 	}
 }
 
@@ -39,15 +39,12 @@ void SingleThreadSchedulerBase::flush()
 {
 	RD_ASSERT_MSG(!is_active(), "Can't flush this scheduler in a reentrant way: we are inside queued item's execution");
 
-	while (tasks_executing != 0)
-	{
-		std::this_thread::yield();
-	}
+	tasks_executing.wait_for_zero();
 }
 
 void SingleThreadSchedulerBase::queue(std::function<void()> action)
 {
-	++tasks_executing;
+	tasks_executing.increment();
 	PoolTask task(action, this);
 	pool->push(std::move(task));
 }
@@ -9,6 +9,7 @@
 #include "scheduler/base/IScheduler.h"
 #include "lifetime/Lifetime.h"
 #include "spdlog/spdlog.h"
+#include "util/completion.h"
 
 #include <utility>
 
@@ -27,7 +28,7 @@ protected:
 	std::shared_ptr<spdlog::logger> log;
 	std::string name;
 
-	std::atomic_uint32_t tasks_executing{0};
+	util::pending_counter tasks_executing;
 	std::atomic_uint32_t active{0};
 	std::unique_ptr<ctpl::thread_pool> pool;
 
@@ -9,7 +9,7 @@
 #include "protocol/Buffer.h"
 #include "protocol/RdId.h"
 
-#include "std/unordered_map.h"
+#include "std/flat_hash_map.h"
 
 #include <functional>
 #include <string>
@@ -36,7 +36,7 @@ class RD_FRAMEWORK_API SerializationCtx
 	Serializers const* serializers = nullptr;
 
 public:
-	using roots_t = rd::unordered_map<util::hash_t, InternRoot const*>;
+	using roots_t = rd::flat_hash_map<util::hash_t, InternRoot const*>;
 
 	roots_t intern_roots{};
 
@@ -81,7 +81,7 @@ Wrapper<T> SerializationCtx::readInterned(Buffer& buffer, std::function<T(Serial
 	auto it = intern_roots.find(InternKey);
 	if (it != intern_roots.end())
 	{
-		int32_t index = buffer.read_integral<int32_t>() ^ 1;
+		int32_t index = buffer.read_varint<int32_t>() ^ 1;
 		return it->second->un_intern_value<T>(index);
 	}
 	else
@@ -97,7 +97,7 @@ void SerializationCtx::writeInterned(Buffer& buffer, const Wrapper<T>& value, F&
 	if (it != intern_roots.end())
 	{
 		int32_t index = it->second->intern_value<T>(value);
-		buffer.write_integral<int32_t>(index);
+		buffer.write_varint<int32_t>(index);
 	}
 	else
 	{
@@ -43,6 +43,42 @@ void Serializers::register_in()
 	};
 }
 
+bool Serializers::is_registered(RdId id) const
+{
+	for (auto const& table : static_tables)
+	{
+		if (table.find(id) != nullptr)
+		{
+			return true;
+		}
+	}
+	return readers.count(id) != 0;
+}
+
+void Serializers::registry(StaticTypeTable table) const
+{
+	for (auto const& registered : static_tables)
+	{
+		if (registered == table)
+		{
+			return;
+		}
+	}
+
+	for (auto const& entry : table)
+	{
+		if (entry.reader == nullptr)
+		{
+			continue;
+		}
+		std::string type_name = entry.type_name();
+		RD_ASSERT_MSG(entry.id == RdId(util::getPlatformIndependentHash(type_name)),
+			"Static type name doesn't match " + type_name);
+		RD_ASSERT_MSG(!is_registered(entry.id), "Can't register " + type_name + " with id: " + to_string(entry.id));
+	}
+	static_tables.push_back(table);
+}
+
 Serializers::Serializers()
 {
 	register_in();
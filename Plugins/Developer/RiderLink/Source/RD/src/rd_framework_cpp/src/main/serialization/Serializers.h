@@ -13,12 +13,14 @@
 #include "hashing.h"
 #include "serialization/RdAny.h"
 #include "DefaultAbstractDeclaration.h"
+#include "StaticTypeRegistry.h"
 
-#include "std/unordered_map.h"
+#include "std/flat_hash_map.h"
 
 #include <utility>
 #include <iostream>
 #include <unordered_set>
+#include <vector>
 
 #include <rd_framework_export.h>
 
@@ -46,7 +48,12 @@ private:
 
 	void register_in();
 
-	mutable rd::unordered_map<RdId, std::function<InternedAny(SerializationCtx&, Buffer&)>> readers;
+	// probed before [readers], registered at runtime
+	mutable std::vector<StaticTypeTable> static_tables;
+
+	mutable rd::flat_hash_map<RdId, StaticTypeEntry::reader_t> readers;
+
+	bool is_registered(RdId id) const;
 
 public:
 	Serializers();
@@ -54,6 +61,11 @@ public:
 	template <typename T, typename = typename std::enable_if_t<util::is_base_of_v<IPolymorphicSerializable, T>>>
 	void registry() const;
 
+	/**
+	 * \brief Registers all types of [table] at once, see [StaticTypeRegistry]. The registry must outlive this object.
+	 */
+	void registry(StaticTypeTable table) const;
+
 	template <typename T = DefaultAbstractDeclaration>
 	optional<InternedAny> readAny(SerializationCtx& ctx, Buffer& buffer) const;
 
@@ -83,11 +95,9 @@ void Serializers::registry() const
 	util::hash_t h = util::getPlatformIndependentHash(type_name);
 	RdId id(h);
 
-	RD_ASSERT_MSG(readers.count(id) == 0, "Can't register " + type_name + " with id: " + to_string(id));
+	RD_ASSERT_MSG(!is_registered(id), "Can't register " + type_name + " with id: " + to_string(id));
 
-	readers[id] = [](SerializationCtx& ctx, Buffer& buffer) -> Wrapper<IPolymorphicSerializable> {
-		return wrapper::make_wrapper<T>(T::read(ctx, buffer));
-	};
+	readers[id] = &read_static_type<T>;
 }
 
 template <typename T>
@@ -101,12 +111,19 @@ optional<InternedAny> Serializers::readAny(SerializationCtx& ctx, Buffer& buffer
 	int32_t size = buffer.read_integral<int32_t>();
 	buffer.check_available(static_cast<size_t>(size));
 
-	if (readers.count(id) == 0)
+	for (auto const& table : static_tables)
+	{
+		if (auto reader = table.find(id))
+		{
+			return reader(ctx, buffer);
+		}
+	}
+	auto it = readers.find(id);
+	if (it == readers.end())
 	{
 		return any::make_interned_any<T>(T::readUnknownInstance(ctx, buffer, id, size));
 	}
-	auto const& reader = readers.at(id);
-	return reader(ctx, buffer);
+	return it->second(ctx, buffer);
 }
 
 template <typename T>
@@ -0,0 +1,219 @@
+#ifndef RD_CPP_STATICTYPEREGISTRY_H
+#define RD_CPP_STATICTYPEREGISTRY_H
+
+#include "protocol/RdId.h"
+#include "serialization/RdAny.h"
+#include "hashing.h"
+#include "types/wrapper.h"
+
+#include "thirdparty.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace rd
+{
+// region predeclared
+
+class SerializationCtx;
+
+class Buffer;
+// endregion
+
+/**
+ * \brief Id and reader of a polymorphic type known at compile time, see [static_type].
+ */
+struct StaticTypeEntry
+{
+	using reader_t = InternedAny (*)(SerializationCtx&, Buffer&);
+	using type_name_t = std::string (*)();
+
+	RdId id{};
+	reader_t reader = nullptr;
+	type_name_t type_name = nullptr;
+};
+
+template <typename T>
+InternedAny read_static_type(SerializationCtx& ctx, Buffer& buffer)
+{
+	return any::make_interned_any<T>(wrapper::make_wrapper<T>(T::read(ctx, buffer)));
+}
+
+/**
+ * \brief Entry of [T] whose [type_name] must be the one returned by T::static_type_name(), it's checked on
+ * registration.
+ */
+template <typename T>
+constexpr StaticTypeEntry static_type(string_view type_name)
+{
+	return {RdId(util::getPlatformIndependentHash(type_name)), &read_static_type<T>, &T::static_type_name};
+}
+
+/**
+ * \brief Read-only view of the table of a [StaticTypeRegistry].
+ */
+class StaticTypeTable
+{
+	StaticTypeEntry const* slots = nullptr;
+	size_t capacity = 0;
+	size_t shift = 0;
+	uint64_t multiplier = 0;
+
+public:
+	constexpr StaticTypeTable() = default;
+
+	constexpr StaticTypeTable(StaticTypeEntry const* slots, size_t capacity, size_t shift, uint64_t multiplier)
+		: slots(slots), capacity(capacity), shift(shift), multiplier(multiplier)
+	{
+	}
+
+	static constexpr size_t slot_of(RdId id, size_t shift, uint64_t multiplier)
+	{
+		return static_cast<size_t>((static_cast<uint64_t>(id.get_hash()) * multiplier) >> shift);
+	}
+
+	/**
+	 * \brief Reader of [id], nullptr if it's not in the table.
+	 */
+	constexpr StaticTypeEntry::reader_t find(RdId id) const
+	{
+		for (size_t i = slot_of(id, shift, multiplier);; i = (i + 1) & (capacity - 1))
+		{
+			StaticTypeEntry const& entry = slots[i];
+			if (entry.reader == nullptr || entry.id == id)
+			{
+				return entry.reader;
+			}
+		}
+	}
+
+	constexpr StaticTypeEntry const* begin() const
+	{
+		return slots;
+	}
+
+	constexpr StaticTypeEntry const* end() const
+	{
+		return slots + capacity;
+	}
+
+	constexpr bool operator==(StaticTypeTable const& other) const
+	{
+		return slots == other.slots;
+	}
+};
+
+/**
+ * \brief Table of polymorphic types built at compile time, so that [Serializers] finds the reader of a known type with
+ * a single probe in most cases instead of a runtime map lookup. The multiplier of the hash is picked among a few
+ * candidates to spread the ids best, a perfect one is usually found for the size of generated models.
+ *
+ * Is meant to be a constexpr variable with static storage, [Serializers] keeps a view of its table:
+ * \code
+ * static constexpr auto types = rd::make_static_type_registry(rd::static_type<Foo>("Foo"), rd::static_type<Bar>("Bar"));
+ * serializers.registry(types.table());
+ * \endcode
+ *
+ * \tparam N count of types
+ */
+template <size_t N>
+class StaticTypeRegistry
+{
+	static_assert(N > 0, "Registry must have at least one type");
+
+	static constexpr size_t bits_for(size_t count)
+	{
+		// load factor is kept under a half
+		size_t bits = 1;
+		while ((size_t(1) << bits) < 2 * count)
+		{
+			++bits;
+		}
+		return bits;
+	}
+
+	static constexpr size_t BITS = bits_for(N);
+	static constexpr size_t CAPACITY = size_t(1) << BITS;
+	static constexpr size_t SHIFT = 64 - BITS;
+	static constexpr size_t MULTIPLIER_CANDIDATES = 64;
+
+	StaticTypeEntry slots[CAPACITY]{};
+	uint64_t multiplier = 0;
+
+	static constexpr uint64_t candidate(size_t index)
+	{
+		return 0x9E3779B97F4A7C15ULL + 2 * static_cast<uint64_t>(index);
+	}
+
+	// sum of the distances of the entries from their home slots
+	static constexpr size_t displacement(StaticTypeEntry const (&entries)[N], uint64_t multiplier)
+	{
+		bool occupied[CAPACITY]{};
+		size_t total = 0;
+		for (size_t k = 0; k < N; ++k)
+		{
+			size_t i = StaticTypeTable::slot_of(entries[k].id, SHIFT, multiplier);
+			while (occupied[i])
+			{
+				i = (i + 1) & (CAPACITY - 1);
+				++total;
+			}
+			occupied[i] = true;
+		}
+		return total;
+	}
+
+public:
+	explicit constexpr StaticTypeRegistry(StaticTypeEntry const (&entries)[N])
+	{
+		for (size_t k = 0; k < N; ++k)
+		{
+			for (size_t j = 0; j < k; ++j)
+			{
+				if (entries[j].id == entries[k].id)
+				{
+					throw std::invalid_argument("Type is registered twice or type names collide");
+				}
+			}
+		}
+
+		size_t best = displacement(entries, candidate(0));
+		multiplier = candidate(0);
+		for (size_t c = 1; c < MULTIPLIER_CANDIDATES && best > 0; ++c)
+		{
+			const size_t current = displacement(entries, candidate(c));
+			if (current < best)
+			{
+				best = current;
+				multiplier = candidate(c);
+			}
+		}
+
+		for (size_t k = 0; k < N; ++k)
+		{
+			size_t i = StaticTypeTable::slot_of(entries[k].id, SHIFT, multiplier);
+			while (slots[i].reader != nullptr)
+			{
+				i = (i + 1) & (CAPACITY - 1);
+			}
+			slots[i] = entries[k];
+		}
+	}
+
+	constexpr StaticTypeTable table() const
+	{
+		return StaticTypeTable(slots, CAPACITY, SHIFT, multiplier);
+	}
+};
+
+template <typename... Entries>
+constexpr StaticTypeRegistry<sizeof...(Entries)> make_static_type_registry(Entries const&... entries)
+{
+	const StaticTypeEntry list[] = {entries...};
+	return StaticTypeRegistry<sizeof...(Entries)>(list);
+}
+}	 // namespace rd
+
+#endif	  // RD_CPP_STATICTYPEREGISTRY_H
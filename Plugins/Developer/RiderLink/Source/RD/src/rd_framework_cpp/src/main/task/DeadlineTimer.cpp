@@ -0,0 +1,118 @@
+#include "DeadlineTimer.h"
+
+#include "util/thread_util.h"
+
+#include "spdlog/spdlog.h"
+
+namespace rd
+{
+constexpr DeadlineTimer::registration_t DeadlineTimer::INVALID_REGISTRATION;
+
+DeadlineTimer::DeadlineTimer() : thread([this] { run(); })
+{
+}
+
+DeadlineTimer::~DeadlineTimer()
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		stopped = true;
+	}
+	cv.notify_all();
+	if (thread.joinable())
+	{
+		thread.join();
+	}
+}
+
+DeadlineTimer::registration_t DeadlineTimer::add(clock_t::time_point deadline, std::function<void()> action)
+{
+	registration_t registration;
+	bool earliest;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		registration = next_registration++;
+		actions.emplace(registration, std::move(action));
+		auto it = deadlines.emplace(deadline, registration);
+		earliest = it == deadlines.begin();
+	}
+	// the thread sleeps until the earliest deadline known to it
+	if (earliest)
+	{
+		cv.notify_one();
+	}
+	return registration;
+}
+
+void DeadlineTimer::remove(registration_t registration)
+{
+	if (registration == INVALID_REGISTRATION)
+	{
+		return;
+	}
+
+	std::function<void()> action;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		auto it = actions.find(registration);
+		if (it == actions.end())
+		{
+			return;
+		}
+		// its deadline is skipped when it comes
+		action = std::move(it->second);
+		actions.erase(it);
+	}
+	// captures are released outside of the lock
+}
+
+void DeadlineTimer::run()
+{
+	util::set_thread_name("RdDeadlineTimer");
+
+	std::unique_lock<std::mutex> guard(lock);
+	while (!stopped)
+	{
+		if (deadlines.empty())
+		{
+			cv.wait(guard);
+			continue;
+		}
+
+		auto first = deadlines.begin();
+		if (first->first > clock_t::now())
+		{
+			cv.wait_until(guard, first->first);
+			continue;
+		}
+
+		const registration_t registration = first->second;
+		deadlines.erase(first);
+		auto it = actions.find(registration);
+		if (it == actions.end())
+		{
+			continue;
+		}
+		auto action = std::move(it->second);
+		actions.erase(it);
+
+		guard.unlock();
+		try
+		{
+			action();
+		}
+		catch (std::exception const& e)
+		{
+			spdlog::error("DeadlineTimer: action failed | {}", e.what());
+		}
+		action = nullptr;
+		guard.lock();
+	}
+}
+
+DeadlineTimer& DeadlineTimer::Instance()
+{
+	static DeadlineTimer globalDeadlineTimer;
+	return globalDeadlineTimer;
+}
+}	 // namespace rd
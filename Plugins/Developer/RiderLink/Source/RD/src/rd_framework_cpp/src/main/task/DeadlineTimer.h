@@ -0,0 +1,77 @@
+#ifndef RD_CPP_DEADLINETIMER_H
+#define RD_CPP_DEADLINETIMER_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Invokes actions once their deadlines pass, on a single background thread shared by all calls.
+ * Actions must not block, e.g. they queue the actual work on a scheduler.
+ */
+class RD_FRAMEWORK_API DeadlineTimer
+{
+public:
+	using registration_t = int64_t;
+	using clock_t = std::chrono::steady_clock;
+
+	static constexpr registration_t INVALID_REGISTRATION = 0;
+
+private:
+	std::mutex lock;
+	std::condition_variable cv;
+	std::multimap<clock_t::time_point, registration_t> deadlines;
+	std::unordered_map<registration_t, std::function<void()>> actions;
+	registration_t next_registration = 1;
+	bool stopped = false;
+
+	std::thread thread;
+
+	void run();
+
+public:
+	// region ctor/dtor
+
+	DeadlineTimer();
+
+	DeadlineTimer(DeadlineTimer const&) = delete;
+
+	DeadlineTimer& operator=(DeadlineTimer const&) = delete;
+
+	~DeadlineTimer();
+	// endregion
+
+	/**
+	 * \brief Invokes [action] at [deadline] unless it's removed before.
+	 */
+	registration_t add(clock_t::time_point deadline, std::function<void()> action);
+
+	/**
+	 * \brief Forgets the action of [registration] if it hasn't been invoked yet.
+	 */
+	void remove(registration_t registration);
+
+	/**
+	 * \brief global timer for whole application, its thread is started on first use.
+	 */
+	static DeadlineTimer& Instance();
+};
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_DEADLINETIMER_H
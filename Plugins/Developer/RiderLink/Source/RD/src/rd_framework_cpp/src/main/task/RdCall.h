@@ -6,8 +6,15 @@
 #include "RdTaskResult.h"
 #include "scheduler/SynchronousScheduler.h"
 #include "WiredRdTask.h"
+#include "DeadlineTimer.h"
+#include "lifetime/LifetimeDefinition.h"
+#include "util/completion.h"
 
+#include <memory>
+#include <stdexcept>
 #include <thread>
+#include <utility>
+#include <vector>
 
 #if defined(_MSC_VER)
 #pragma warning(push)
@@ -30,9 +37,87 @@ class RdCall : public virtual RdReactiveBase, public ISerializable
 	using WTReq = value_or_wrapper<TReq>;
 	using WTRes = value_or_wrapper<TRes>;
 
-	mutable optional<RdId> sync_task_id;
-
 public:
+	using result_handler_t = std::function<void(RdTaskResult<TRes, ResSer> const&)>;
+
+	/**
+	 * \brief Collects requests of one call to send them in a single package, so that they cost one round trip.
+	 * Requests are sent by [send], the tasks of the requests which haven't been sent are cancelled by their deadline.
+	 */
+	class Batch
+	{
+		RdCall const* call;
+		std::chrono::milliseconds timeout;
+		IScheduler* scheduler;
+		// task id followed by serialized request
+		std::vector<Buffer::ByteArray> requests;
+		// integral encoding of [requests], taken from the wire by the first of them
+		bool varint_integrals = false;
+
+	public:
+		// region ctor/dtor
+
+		Batch(RdCall const& call, std::chrono::milliseconds timeout, IScheduler* scheduler)
+			: call(&call), timeout(timeout), scheduler(scheduler)
+		{
+		}
+
+		Batch(Batch&&) = default;
+
+		Batch& operator=(Batch&&) = default;
+		// endregion
+
+		/**
+		 * \brief Adds [request] to the batch. @see RdCall::start with a result handler
+		 */
+		WiredRdTask<TRes, ResSer> add(TReq const& request, result_handler_t on_result = nullptr)
+		{
+			RdId task_id = call->next_task_id();
+			auto task = call->create_task(task_id, scheduler, timeout, std::move(on_result));
+
+			if (requests.empty())
+			{
+				varint_integrals = call->get_wire()->varint_integrals();
+			}
+			Buffer buffer;
+			buffer.set_varint_integrals(varint_integrals);
+			task_id.write(buffer);
+			ReqSer::write(call->get_serialization_context(), buffer, request);
+			RD_TRACE_SEND("call {}::{} batch request {} : {}", to_string(call->location), to_string(call->rdid), to_string(task_id),
+				to_string(request));
+			requests.push_back(std::move(buffer).getRealArray());
+			return task;
+		}
+
+		size_t size() const
+		{
+			return requests.size();
+		}
+
+		/**
+		 * \brief Sends the requests added so far in a single package and clears the batch.
+		 */
+		void send()
+		{
+			if (requests.empty())
+			{
+				return;
+			}
+
+			std::vector<std::pair<RdId, std::function<void(Buffer& buffer)>>> messages;
+			messages.reserve(requests.size());
+			for (auto const& request : requests)
+			{
+				messages.emplace_back(call->rdid, [&request, varint = varint_integrals](Buffer& buffer) {
+					buffer.set_varint_integrals(varint);
+					buffer.write_byte_array_raw(request);
+				});
+			}
+			call->get_wire()->send_batch(messages);
+			requests.clear();
+		}
+	};
+
 	// region ctor/dtor
 	RdCall() = default;
 
@@ -71,17 +156,27 @@ public:
 	 */
 	WiredRdTask<TRes, ResSer> sync(TReq const& request, std::chrono::milliseconds timeout = std::chrono::milliseconds(200)) const
 	{
-		auto task = start_internal(request, true, &SynchronousScheduler::Instance());
+		auto completion = std::make_shared<util::completion_event>();
+		RdId task_id = next_task_id();
+		auto task = create_task(task_id, &SynchronousScheduler::Instance());
+		// before sending: the response may be received on the wire thread right away
+		task.advise(Lifetime::Eternal(), [completion](RdTaskResult<TRes, ResSer> const&) { completion->complete(); });
+		send_request(task_id, request, true);
 		auto time_at_start = std::chrono::system_clock::now();
-		while (!task.has_value() && !(*bind_lifetime)->is_terminated() &&
-			   ((std::chrono::system_clock::now() - time_at_start) < timeout))
+		try
 		{
-			std::this_thread::yield();
+			// termination of the call wakes up the caller as well
+			LifetimeDefinition waiting(*bind_lifetime);
+			waiting.lifetime->add_action([completion] { completion->complete(); });
+			completion->wait_for(timeout);
+		}
+		catch (std::invalid_argument const&)
+		{
+			// the call has been terminated before the nested lifetime was attached, there is nothing to wait for
 		}
 		spdlog::debug("Time elapsed: {}, has_value={}", to_string(std::chrono::system_clock::now() - time_at_start),
 			to_string(task.has_value()));
 		task.value_or_throw().unwrap();	   // check for existing value
-		sync_task_id = nullopt;
 		return task;
 	}
 
@@ -99,7 +194,41 @@ public:
 	 */
 	WiredRdTask<TRes, ResSer> start(TReq const& request, IScheduler* responseScheduler = nullptr) const
 	{
-		return start_internal(request, false, responseScheduler ? responseScheduler : get_default_scheduler());
+		RdId task_id = next_task_id();
+		auto task = create_task(task_id, responseScheduler ? responseScheduler : get_default_scheduler());
+		send_request(task_id, request, false);
+		return task;
+	}
+
+	/**
+	 * \brief Invokes the API without waiting, any number of such invocations may be in flight at once.
+	 * [on_result] is invoked on [responseScheduler] with the response or with cancellation once [timeout] expires,
+	 * or on the terminating thread if the call is unbound. The task is kept alive until then even if it's dropped.
+	 *
+	 * \param request value of request
+	 * \param timeout after which the task is cancelled unless it's completed
+	 * \param responseScheduler to assign value and to invoke [on_result] on
+	 * \param on_result handler of the task result
+	 * \return task which will have its result value.
+	 */
+	WiredRdTask<TRes, ResSer> start(TReq const& request, std::chrono::milliseconds timeout, IScheduler* responseScheduler,
+		result_handler_t on_result) const
+	{
+		RdId task_id = next_task_id();
+		auto task = create_task(
+			task_id, responseScheduler ? responseScheduler : get_default_scheduler(), timeout, std::move(on_result));
+		send_request(task_id, request, false);
+		return task;
+	}
+
+	/**
+	 * \brief Starts a batch of invocations whose requests are sent together, each with the given [timeout].
+	 * Results are assigned on [responseScheduler].
+	 */
+	Batch batch(std::chrono::milliseconds timeout, IScheduler* responseScheduler = nullptr) const
+	{
+		assert_bound();
+		return Batch(*this, timeout, responseScheduler ? responseScheduler : get_default_scheduler());
 	}
 
 	void on_wire_received(Buffer buffer) const override
@@ -108,35 +237,46 @@ public:
 	}
 
 private:
-	WiredRdTask<TRes, ResSer> start_internal(TReq const& request, bool sync, IScheduler* scheduler) const
+	RdId next_task_id() const
 	{
 		assert_bound();
 		if (!async)
 		{
 			assert_threading();
 		}
+		return get_protocol()->get_identity()->next(rdid);
+	}
 
-		RdId task_id = get_protocol()->get_identity()->next(rdid);
-		WiredRdTask<TRes, ResSer> task{*bind_lifetime, *this, task_id, scheduler};
+	WiredRdTask<TRes, ResSer> create_task(RdId const& task_id, IScheduler* scheduler) const
+	{
+		return WiredRdTask<TRes, ResSer>{*bind_lifetime, *this, task_id, scheduler};
+	}
 
-		if (sync)
-		{
-			if (sync_task_id.has_value())
+	WiredRdTask<TRes, ResSer> create_task(
+		RdId const& task_id, IScheduler* scheduler, std::chrono::milliseconds timeout, result_handler_t on_result) const
+	{
+		auto task = create_task(task_id, scheduler);
+		// the timer keeps the task alive until it's completed
+		auto deadline = DeadlineTimer::Instance().add(DeadlineTimer::clock_t::now() + timeout,
+			[task, scheduler] { scheduler->queue([task] { task.set_result_if_empty(typename RdTaskResult<TRes, ResSer>::Cancelled{}); }); });
+		task.advise(Lifetime::Eternal(), [deadline, on_result = std::move(on_result)](RdTaskResult<TRes, ResSer> const& result) {
+			if (on_result)
 			{
-				throw std::invalid_argument(
-					"Already exists sync task for call " + to_string(location) + ", taskId = " + rd::to_string(*sync_task_id));
+				on_result(result);
 			}
-			sync_task_id = task_id;
-		}
+			DeadlineTimer::Instance().remove(deadline);
+		});
+		return task;
+	}
 
+	void send_request(RdId const& task_id, TReq const& request, bool sync) const
+	{
 		get_wire()->send(rdid, [&](Buffer& buffer) {
-			spdlog::get("logSend")->trace("call {}::{} send {} request {} : {}", to_string(location), to_string(rdid), (sync ? "SYNC" : "ASYNC"),
+			RD_TRACE_SEND("call {}::{} send {} request {} : {}", to_string(location), to_string(rdid), (sync ? "SYNC" : "ASYNC"),
 				to_string(task_id), to_string(request));
 			task_id.write(buffer);
 			ReqSer::write(get_serialization_context(), buffer, request);
 		});
-
-		return task;
 	}
 
 public:
@@ -2,7 +2,12 @@
 #define RD_CPP_RDENDPOINT_H
 
 #include "serialization/Polymorphic.h"
+#include "std/flat_hash_map.h"
 #include "RdTask.h"
+#include "lifetime/LifetimeDefinition.h"
+
+#include <memory>
+#include <mutex>
 
 #if defined(_MSC_VER)
 #pragma warning(push)
@@ -28,7 +33,44 @@ class RdEndpoint : public virtual RdReactiveBase, public ISerializable
 	using handler_t = std::function<RdTask<TRes, ResSer>(Lifetime, TReq const&)>;
 	mutable handler_t local_handler;
 
-	mutable tsl::ordered_map<RdId, RdTask<TRes, ResSer>, rd::hash<RdId>> awaiting_tasks;	// TO-DO get rid of it
+	/**
+	 * \brief Requests whose response hasn't been sent yet. Handlers may complete them on any thread.
+	 */
+	struct AwaitingTasks
+	{
+		struct Request
+		{
+			// keeps the task alive until it's completed, even if the handler doesn't
+			RdTask<TRes, ResSer> task;
+			// passed to the handler, terminated once the response is sent or the endpoint is unbound
+			LifetimeDefinition lifetime;
+		};
+
+		std::mutex lock;
+		rd::flat_hash_map<RdId, Request> requests;
+	};
+
+	mutable std::shared_ptr<AwaitingTasks> awaiting_tasks{std::make_shared<AwaitingTasks>()};
+
+	mutable IScheduler* wire_scheduler = nullptr;
+
+	void complete(RdId task_id) const
+	{
+		optional<typename AwaitingTasks::Request> request;
+		{
+			std::lock_guard<std::mutex> guard(awaiting_tasks->lock);
+			auto it = awaiting_tasks->requests.find(task_id);
+			if (it == awaiting_tasks->requests.end())
+			{
+				return;
+			}
+			request = std::move(it->second);
+			awaiting_tasks->requests.erase(it);
+		}
+		// terminates the request lifetime outside of the lock, its action takes it as well
+		request.reset();
+	}
+
 public:
 	// region ctor/dtor
 
@@ -83,6 +125,22 @@ public:
 		{ return RdTask<TRes, ResSer>::from_result(handler(req)); };
 	}
 
+	/**
+	 * \brief Handles requests on [scheduler] instead of the protocol one, e.g. on a SerialScheduler of a
+	 * WorkStealingScheduler so that heavy handlers run in parallel with other entities. Requests of this endpoint
+	 * are expected to be handled one at a time, so [scheduler] mustn't be out of order.
+	 */
+	void set_wire_scheduler(IScheduler* scheduler) const
+	{
+		RD_ASSERT_MSG(scheduler == nullptr || !scheduler->out_of_order_execution, "endpoint requires a serial scheduler");
+		wire_scheduler = scheduler;
+	}
+
+	IScheduler* get_wire_scheduler() const override
+	{
+		return wire_scheduler != nullptr ? wire_scheduler : get_default_scheduler();
+	}
+
 	void init(Lifetime lifetime) const override
 	{
 		RdReactiveBase::init(lifetime);
@@ -94,31 +152,54 @@ public:
 	{
 		auto task_id = RdId::read(buffer);
 		auto value = ReqSer::read(get_serialization_context(), buffer);
-		spdlog::get("logReceived")->trace("endpoint {}::{} request = {}", to_string(location), to_string(rdid), to_string(value));
+		RD_TRACE_RECEIVED("endpoint {}::{} request = {}", to_string(location), to_string(rdid), to_string(value));
 		if (!local_handler)
 		{
 			throw std::invalid_argument("handler is empty for RdEndPoint");
 		}
-		auto task = awaiting_tasks[task_id] = {};
+		LifetimeDefinition request_lifetime_definition(*bind_lifetime);
+		const Lifetime request_lifetime = request_lifetime_definition.lifetime;
+		request_lifetime->add_action([weak_awaiting = std::weak_ptr<AwaitingTasks>(awaiting_tasks), task_id] {
+			if (auto awaiting = weak_awaiting.lock())
+			{
+				std::lock_guard<std::mutex> guard(awaiting->lock);
+				awaiting->requests.erase(task_id);
+			}
+		});
+
+		RdTask<TRes, ResSer> task;
 		try
 		{
-			task = local_handler(*bind_lifetime, wrapper::get<TReq>(value));
+			task = local_handler(request_lifetime, wrapper::get<TReq>(value));
 		}
 		catch (std::exception const& e)
 		{
 			task.fault(e);
 		}
-		task.advise(*bind_lifetime,
-			[this, task_id, &task](RdTaskResult<TRes, ResSer> const& task_result)
+		{
+			std::lock_guard<std::mutex> guard(awaiting_tasks->lock);
+			awaiting_tasks->requests.emplace(
+				task_id, typename AwaitingTasks::Request{task, std::move(request_lifetime_definition)});
+		}
+		task.advise(request_lifetime,
+			[this, task_id](RdTaskResult<TRes, ResSer> const& task_result)
 			{
-				spdlog::get("logSend")->trace(
-					"endpoint {}::{} response = {}", to_string(location), to_string(rdid), to_string(*task.result));
+				RD_TRACE_SEND("endpoint {}::{} response = {}", to_string(location), to_string(rdid), to_string(task_result));
 				get_wire()->send(
 					task_id, [&](Buffer& inner_buffer) { task_result.write(get_serialization_context(), inner_buffer); });
-				// TO-DO remove from awaiting_tasks
+				complete(task_id);
 			});
 	}
 
+	/**
+	 * \brief Number of requests being handled, i.e. received and not responded yet.
+	 */
+	size_t get_awaiting_tasks_count() const
+	{
+		std::lock_guard<std::mutex> guard(awaiting_tasks->lock);
+		return awaiting_tasks->requests.size();
+	}
+
 	friend bool operator==(const RdEndpoint& lhs, const RdEndpoint& rhs)
 	{
 		return &lhs == &rhs;
@@ -18,7 +18,8 @@ public:
 	WiredRdTask() = delete;
 
 	WiredRdTask(Lifetime lifetime, RdReactiveBase const& call, RdId rdid, IScheduler* scheduler)
-		: impl(std::make_shared<detail::WiredRdTaskImpl<T, S>>(lifetime, call, rdid, scheduler, RdTask<T, S>::result))
+		: impl(std::make_shared<detail::WiredRdTaskImpl<T, S>>(
+			  lifetime, call, rdid, scheduler, std::shared_ptr<Property<RdTaskResult<T, S>>>(RdTask<T, S>::impl, RdTask<T, S>::result)))
 	{
 	}
 
@@ -3,6 +3,9 @@
 
 #include "serialization/Polymorphic.h"
 #include "RdTaskResult.h"
+#include "lifetime/LifetimeDefinition.h"
+
+#include <memory>
 
 namespace rd
 {
@@ -16,9 +19,12 @@ class WiredRdTaskImpl : public RdReactiveBase
 {
 private:
 	Lifetime lifetime;
+	// subscription for the response, dropped together with the task
+	LifetimeDefinition wire_lifetime;
 	RdReactiveBase const* cutpoint{};
 	IScheduler* scheduler{};
-	Property<RdTaskResult<T, S>>* result{};
+	// shared with the task, so the response is delivered even if the task is dropped meanwhile
+	std::shared_ptr<Property<RdTaskResult<T, S>>> result{};
 
 	LifetimeImpl::counter_t termination_lifetime_id{};
 
@@ -26,14 +32,14 @@ public:
 	template <typename, typename>
 	friend class ::rd::WiredRdTask;
 
-	WiredRdTaskImpl(
-		Lifetime lifetime, RdReactiveBase const& cutpoint, RdId rdid, IScheduler* scheduler, Property<RdTaskResult<T, S>>* result)
-		: lifetime(lifetime), cutpoint(&cutpoint), scheduler(scheduler), result(result)
+	WiredRdTaskImpl(Lifetime lifetime, RdReactiveBase const& cutpoint, RdId rdid, IScheduler* scheduler,
+		std::shared_ptr<Property<RdTaskResult<T, S>>> result)
+		: lifetime(lifetime), wire_lifetime(lifetime), cutpoint(&cutpoint), scheduler(scheduler), result(std::move(result))
 	{
 		this->rdid = std::move(rdid);
-		cutpoint.get_wire()->advise(lifetime, this);
-		termination_lifetime_id =
-			lifetime->add_action([this]() { this->result->set_if_empty(typename RdTaskResult<T, S>::Cancelled{}); });
+		cutpoint.get_wire()->advise(wire_lifetime.lifetime, this);
+		termination_lifetime_id = lifetime->add_action(
+			[result = this->result]() { result->set_if_empty(typename RdTaskResult<T, S>::Cancelled{}); });
 	}
 
 	virtual ~WiredRdTaskImpl()
@@ -44,18 +50,16 @@ public:
 	void on_wire_received(Buffer buffer) const override
 	{
 		auto read_result = RdTaskResult<T, S>::read(cutpoint->get_serialization_context(), buffer);
-		spdlog::get("logReceived")
-			->trace("call {} {} received response {} : {}", to_string(cutpoint->get_location()), to_string(rdid), to_string(rdid),
-				to_string(read_result));
-		scheduler->queue([&, result = std::move(read_result)]() mutable {
-			if (this->result->has_value())
+		RD_TRACE_RECEIVED("call {} {} received response {} : {}", to_string(cutpoint->get_location()), to_string(rdid), to_string(rdid),
+			to_string(read_result));
+		scheduler->queue([task_result = this->result, rdid = rdid, result = std::move(read_result)]() mutable {
+			if (task_result->has_value())
 			{
-				spdlog::get("logReceived")->trace("call {} {} response was dropped, task result is: {}", to_string(location), to_string(rdid),
-					to_string(result.unwrap()));
+				RD_TRACE_RECEIVED("call {} response was dropped, task result is: {}", to_string(rdid), to_string(result.unwrap()));
 			}
 			else
 			{
-				this->result->set_if_empty(std::move(result));
+				task_result->set_if_empty(std::move(result));
 			}
 		});
 	}
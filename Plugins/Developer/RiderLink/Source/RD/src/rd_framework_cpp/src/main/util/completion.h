@@ -0,0 +1,110 @@
+#ifndef RD_CPP_COMPLETION_H
+#define RD_CPP_COMPLETION_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace rd
+{
+namespace util
+{
+/**
+ * \brief One-shot event threads can wait for, parked on a condition variable instead of spinning.
+ */
+class completion_event
+{
+	std::mutex lock;
+	std::condition_variable cv;
+	bool completed = false;
+
+public:
+	void complete()
+	{
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			completed = true;
+		}
+		cv.notify_all();
+	}
+
+	bool is_completed()
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		return completed;
+	}
+
+	/**
+	 * \return false if [timeout] has expired before completion
+	 */
+	template <typename Rep, typename Period>
+	bool wait_for(std::chrono::duration<Rep, Period> timeout)
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		return cv.wait_for(guard, timeout, [this] { return completed; });
+	}
+};
+
+/**
+ * \brief Number of unfinished tasks with a wait for it to drop to zero. Counting itself is lock-free,
+ * the mutex is only taken to wake up waiters.
+ */
+class pending_counter
+{
+	std::atomic<uint32_t> count{0};
+	std::atomic<uint32_t> waiters{0};
+	std::mutex lock;
+	std::condition_variable cv;
+
+	void notify()
+	{
+		// seq_cst pairs with the waiter, which announces itself before checking [count]
+		if (waiters != 0)
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			cv.notify_all();
+		}
+	}
+
+public:
+	void increment()
+	{
+		++count;
+	}
+
+	void decrement()
+	{
+		if (--count == 0)
+		{
+			notify();
+		}
+	}
+
+	/**
+	 * \brief Forgets tasks which will never finish, e.g. dropped by a stopped scheduler.
+	 */
+	void reset()
+	{
+		count = 0;
+		notify();
+	}
+
+	uint32_t get() const
+	{
+		return count;
+	}
+
+	void wait_for_zero()
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		++waiters;
+		cv.wait(guard, [this] { return count == 0; });
+		--waiters;
+	}
+};
+}	 // namespace util
+}	 // namespace rd
+
+#endif	  // RD_CPP_COMPLETION_H
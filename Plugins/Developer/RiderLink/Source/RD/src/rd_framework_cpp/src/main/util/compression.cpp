@@ -0,0 +1,234 @@
+#include "compression.h"
+
+#include <array>
+#include <cstring>
+
+namespace rd
+{
+namespace util
+{
+namespace
+{
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t LAST_LITERALS = 5;
+constexpr size_t MF_LIMIT = 12;
+constexpr size_t MAX_OFFSET = 65535;
+constexpr uint32_t HASH_LOG = 12;
+
+uint32_t read32(uint8_t const* p)
+{
+	uint32_t v;
+	std::memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+uint32_t hash4(uint32_t v)
+{
+	return (v * 2654435761u) >> (32 - HASH_LOG);
+}
+
+uint8_t* write_length(uint8_t* op, size_t len)
+{
+	while (len >= 255)
+	{
+		*op++ = 255;
+		len -= 255;
+	}
+	*op++ = static_cast<uint8_t>(len);
+	return op;
+}
+
+bool read_length(uint8_t const*& ip, uint8_t const* iend, size_t& len)
+{
+	uint8_t b;
+	do
+	{
+		if (ip >= iend)
+		{
+			return false;
+		}
+		b = *ip++;
+		len += b;
+	} while (b == 255);
+	return true;
+}
+}	 // namespace
+
+size_t lz4_compress_bound(size_t size)
+{
+	return size + size / 255 + 16;
+}
+
+size_t lz4_compress(uint8_t const* src, size_t size, uint8_t* dst, size_t capacity)
+{
+	if (size == 0)
+	{
+		// a single token without literals, [src] may be null
+		if (capacity == 0)
+		{
+			return 0;
+		}
+		*dst = 0;
+		return 1;
+	}
+
+	uint8_t* op = dst;
+	uint8_t* const oend = dst + capacity;
+	size_t anchor = 0;
+
+	if (size > MF_LIMIT)
+	{
+		std::array<uint32_t, 1u << HASH_LOG> table{};
+		const size_t match_limit = size - MF_LIMIT;
+		const size_t match_end = size - LAST_LITERALS;
+
+		size_t ip = 0;
+		while (ip < match_limit)
+		{
+			const uint32_t sequence = read32(src + ip);
+			const uint32_t h = hash4(sequence);
+			const size_t ref = table[h];
+			table[h] = static_cast<uint32_t>(ip);
+
+			if (ref >= ip || ip - ref > MAX_OFFSET || read32(src + ref) != sequence)
+			{
+				++ip;
+				continue;
+			}
+
+			size_t match_len = MIN_MATCH;
+			while (ip + match_len < match_end && src[ref + match_len] == src[ip + match_len])
+			{
+				++match_len;
+			}
+
+			const size_t literals = ip - anchor;
+			if (static_cast<size_t>(oend - op) < 1 + literals / 255 + 1 + literals + 2 + match_len / 255 + 1)
+			{
+				return 0;
+			}
+
+			uint8_t* token = op++;
+			if (literals >= 15)
+			{
+				*token = 15 << 4;
+				op = write_length(op, literals - 15);
+			}
+			else
+			{
+				*token = static_cast<uint8_t>(literals << 4);
+			}
+			std::memcpy(op, src + anchor, literals);
+			op += literals;
+
+			const size_t offset = ip - ref;
+			*op++ = static_cast<uint8_t>(offset & 0xFF);
+			*op++ = static_cast<uint8_t>(offset >> 8);
+
+			const size_t match_code = match_len - MIN_MATCH;
+			if (match_code >= 15)
+			{
+				*token |= 15;
+				op = write_length(op, match_code - 15);
+			}
+			else
+			{
+				*token |= static_cast<uint8_t>(match_code);
+			}
+
+			ip += match_len;
+			anchor = ip;
+		}
+	}
+
+	const size_t literals = size - anchor;
+	if (static_cast<size_t>(oend - op) < 1 + literals / 255 + 1 + literals)
+	{
+		return 0;
+	}
+	uint8_t* token = op++;
+	if (literals >= 15)
+	{
+		*token = 15 << 4;
+		op = write_length(op, literals - 15);
+	}
+	else
+	{
+		*token = static_cast<uint8_t>(literals << 4);
+	}
+	std::memcpy(op, src + anchor, literals);
+	op += literals;
+
+	return static_cast<size_t>(op - dst);
+}
+
+bool lz4_decompress(uint8_t const* src, size_t size, uint8_t* dst, size_t raw_size)
+{
+	if (raw_size == 0)
+	{
+		// [dst] may be null
+		return size == 0 || (size == 1 && *src == 0);
+	}
+
+	uint8_t const* ip = src;
+	uint8_t const* const iend = src + size;
+	uint8_t* op = dst;
+	uint8_t* const oend = dst + raw_size;
+
+	while (ip < iend)
+	{
+		const uint8_t token = *ip++;
+
+		size_t literals = token >> 4;
+		if (literals == 15 && !read_length(ip, iend, literals))
+		{
+			return false;
+		}
+		if (static_cast<size_t>(iend - ip) < literals || static_cast<size_t>(oend - op) < literals)
+		{
+			return false;
+		}
+		std::memcpy(op, ip, literals);
+		op += literals;
+		ip += literals;
+
+		if (ip == iend)
+		{
+			// the last sequence has literals only
+			break;
+		}
+
+		if (iend - ip < 2)
+		{
+			return false;
+		}
+		const size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+		ip += 2;
+		if (offset == 0 || offset > static_cast<size_t>(op - dst))
+		{
+			return false;
+		}
+
+		size_t match_len = token & 15;
+		if (match_len == 15 && !read_length(ip, iend, match_len))
+		{
+			return false;
+		}
+		match_len += MIN_MATCH;
+		if (static_cast<size_t>(oend - op) < match_len)
+		{
+			return false;
+		}
+
+		// source and destination may overlap
+		uint8_t const* match = op - offset;
+		for (size_t i = 0; i < match_len; ++i)
+		{
+			op[i] = match[i];
+		}
+		op += match_len;
+	}
+	return op == oend;
+}
+}	 // namespace util
+}	 // namespace rd
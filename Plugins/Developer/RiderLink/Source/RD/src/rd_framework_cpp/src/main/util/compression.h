@@ -0,0 +1,32 @@
+#ifndef RD_CPP_COMPRESSION_H
+#define RD_CPP_COMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+namespace util
+{
+/**
+ * \brief Upper bound of [lz4_compress] output size for [size] input bytes.
+ */
+size_t RD_FRAMEWORK_API lz4_compress_bound(size_t size);
+
+/**
+ * \brief Compresses [src] into [dst] using LZ4 block format.
+ * \return number of bytes written to [dst] or 0 if the result doesn't fit into [capacity].
+ */
+size_t RD_FRAMEWORK_API lz4_compress(uint8_t const* src, size_t size, uint8_t* dst, size_t capacity);
+
+/**
+ * \brief Decompresses LZ4 block [src] into [dst].
+ * \return true if exactly [raw_size] bytes were decompressed.
+ */
+bool RD_FRAMEWORK_API lz4_decompress(uint8_t const* src, size_t size, uint8_t* dst, size_t raw_size);
+}	 // namespace util
+}	 // namespace rd
+
+#endif	  // RD_CPP_COMPRESSION_H
@@ -0,0 +1,87 @@
+#include "ByteArrayPool.h"
+
+namespace rd
+{
+constexpr size_t ByteArrayPool::MIN_CLASS;
+constexpr size_t ByteArrayPool::MAX_CLASS;
+
+size_t ByteArrayPool::DEFAULT_MAX_POOLED_BYTES = 4 * 1024 * 1024;
+
+ByteArrayPool::ByteArrayPool(size_t max_pooled_bytes) : max_pooled_bytes(max_pooled_bytes)
+{
+}
+
+Buffer::ByteArray ByteArrayPool::acquire(size_t min_capacity)
+{
+	size_t size_class = MIN_CLASS;
+	while ((static_cast<size_t>(1) << size_class) < min_capacity)
+	{
+		++size_class;
+	}
+
+	if (size_class <= MAX_CLASS)
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		// larger arrays would be held by small packages until they are acknowledged
+		for (size_t i = size_class; i <= (std::min)(size_class + 1, MAX_CLASS); ++i)
+		{
+			auto& free_arrays = classes[i - MIN_CLASS];
+			if (!free_arrays.empty())
+			{
+				Buffer::ByteArray res = std::move(free_arrays.back());
+				free_arrays.pop_back();
+				pooled_bytes -= res.capacity();
+				++hits;
+
+				res.resize(min_capacity);
+				return res;
+			}
+		}
+	}
+
+	++misses;
+	if (size_class > MAX_CLASS)
+	{
+		// too large to be pooled
+		return Buffer::ByteArray(min_capacity);
+	}
+	// capacity of the whole class, so that the array returns to it when released
+	Buffer::ByteArray res;
+	res.reserve(static_cast<size_t>(1) << size_class);
+	res.resize(min_capacity);
+	return res;
+}
+
+void ByteArrayPool::release(Buffer::ByteArray array)
+{
+	const size_t capacity = array.capacity();
+	if (capacity < (static_cast<size_t>(1) << MIN_CLASS) || capacity >= (static_cast<size_t>(1) << (MAX_CLASS + 1)))
+	{
+		++discarded;
+		return;
+	}
+
+	size_t size_class = MIN_CLASS;
+	while ((static_cast<size_t>(1) << (size_class + 1)) <= capacity)
+	{
+		++size_class;
+	}
+
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		if (pooled_bytes + capacity <= max_pooled_bytes)
+		{
+			pooled_bytes += capacity;
+			classes[size_class - MIN_CLASS].push_back(std::move(array));
+			++recycled;
+			return;
+		}
+	}
+	++discarded;
+}
+
+ByteArrayPool::Stats ByteArrayPool::get_stats() const
+{
+	return Stats{hits, misses, recycled, discarded};
+}
+}	 // namespace rd
@@ -0,0 +1,78 @@
+#ifndef RD_CPP_BYTEARRAYPOOL_H
+#define RD_CPP_BYTEARRAYPOOL_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "protocol/Buffer.h"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Size-classed pool of byte arrays for outgoing packages. Arrays are returned to the pool when they are not
+ * needed anymore (e.g. package was acknowledged by counterpart), so steady-state sending doesn't allocate.
+ */
+class RD_FRAMEWORK_API ByteArrayPool
+{
+public:
+	struct Stats
+	{
+		uint64_t hits;
+		uint64_t misses;
+		uint64_t recycled;
+		uint64_t discarded;
+	};
+
+private:
+	static constexpr size_t MIN_CLASS = 8;	  // 256 bytes
+	static constexpr size_t MAX_CLASS = 20;	  // 1 MiB
+
+	static size_t DEFAULT_MAX_POOLED_BYTES;
+
+	mutable std::mutex lock;
+	std::array<std::vector<Buffer::ByteArray>, MAX_CLASS - MIN_CLASS + 1> classes;
+	size_t pooled_bytes = 0;
+	size_t max_pooled_bytes;
+
+	std::atomic<uint64_t> hits{0};
+	std::atomic<uint64_t> misses{0};
+	std::atomic<uint64_t> recycled{0};
+	std::atomic<uint64_t> discarded{0};
+
+public:
+	// region ctor/dtor
+
+	explicit ByteArrayPool(size_t max_pooled_bytes = DEFAULT_MAX_POOLED_BYTES);
+
+	ByteArrayPool(ByteArrayPool const&) = delete;
+
+	ByteArrayPool& operator=(ByteArrayPool const&) = delete;
+	// endregion
+
+	/**
+	 * \brief Takes an array of the size class of [min_capacity] (or the next one) from the pool or allocates a new one.
+	 * \return array of size [min_capacity], it grows without reallocation up to its capacity.
+	 */
+	Buffer::ByteArray acquire(size_t min_capacity);
+
+	/**
+	 * \brief Returns [array] to the pool, it's freed if the pool is full or array's size doesn't fit any class.
+	 */
+	void release(Buffer::ByteArray array);
+
+	Stats get_stats() const;
+};
+}	 // namespace rd
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_BYTEARRAYPOOL_H
@@ -7,16 +7,29 @@
 
 namespace rd
 {
-size_t ByteBufferAsyncProcessor::INITIAL_CAPACITY = 1024 * 1024;
+size_t ByteBufferAsyncProcessor::DEFAULT_MAX_UNACKNOWLEDGED_BYTES = 64 * 1024 * 1024;
+size_t ByteBufferAsyncProcessor::MAX_BATCH_BYTES = 64 * 1024;
+size_t ByteBufferAsyncProcessor::MAX_BATCH_PACKAGES = 256;
 
 std::shared_ptr<spdlog::logger> ByteBufferAsyncProcessor::logger =
 	spdlog::stderr_color_mt<spdlog::synchronous_factory>("byteBufferLog", spdlog::color_mode::automatic);
 
 ByteBufferAsyncProcessor::ByteBufferAsyncProcessor(
-	std::string id, std::function<bool(Buffer::ByteArray const&, sequence_number_t)> processor)
-	: id(std::move(id)), processor(std::move(processor))
+	std::string id, std::function<bool(batch_t const&, sequence_number_t)> processor, ByteArrayPool* pool)
+	: id(std::move(id)), processor(std::move(processor)), pool(pool)
 {
-	data.reserve(INITIAL_CAPACITY);
+	batch.reserve(MAX_BATCH_PACKAGES);
+}
+
+ByteBufferAsyncProcessor::~ByteBufferAsyncProcessor()
+{
+	IncomingNode* node = incoming.exchange(nullptr);
+	while (node != nullptr)
+	{
+		IncomingNode* next = node->next;
+		delete node;
+		node = next;
+	}
 }
 
 void ByteBufferAsyncProcessor::cleanup0()
@@ -29,6 +42,7 @@ void ByteBufferAsyncProcessor::cleanup0()
 	// TO-DO clean data
 
 	cv.notify_all();
+	notify_processing_thread();
 }
 
 bool ByteBufferAsyncProcessor::terminate0(time_t timeout, StateKind state_to_set, string_view action)
@@ -51,6 +65,7 @@ bool ByteBufferAsyncProcessor::terminate0(time_t timeout, StateKind state_to_set
 		state = state_to_set;
 	}
 	cv.notify_all();
+	notify_processing_thread();
 
 	std::future_status status = async_future.wait_for(timeout);
 
@@ -67,42 +82,131 @@ bool ByteBufferAsyncProcessor::terminate0(time_t timeout, StateKind state_to_set
 	return success;
 }
 
-void ByteBufferAsyncProcessor::add_data(std::vector<Buffer::ByteArray>&& new_data)
+void ByteBufferAsyncProcessor::notify_processing_thread()
+{
+	{
+		// conditions are atomics changed outside of the lock, taking it here prevents a lost wakeup
+		std::lock_guard<decltype(incoming_lock)> guard(incoming_lock);
+	}
+	incoming_cv.notify_all();
+}
+
+void ByteBufferAsyncProcessor::add_data(IncomingNode* new_data)
 {
+	// nodes were pushed in LIFO order
+	IncomingNode* head = nullptr;
+	while (new_data != nullptr)
+	{
+		IncomingNode* next = new_data->next;
+		new_data->next = head;
+		head = new_data;
+		new_data = next;
+	}
+
 	std::lock_guard<decltype(queue_lock)> guard(queue_lock);
-	std::move(new_data.begin(), new_data.end(), std::back_inserter(queue));
-	//		for (auto &&item : new_data) {
-	//			queue.emplace(std::move(item));
-	//		}
+	while (head != nullptr)
+	{
+		IncomingNode* next = head->next;
+		queue.push_back(std::move(head->data));
+		delete head;
+		head = next;
+	}
 }
 
-bool ByteBufferAsyncProcessor::reprocess()
+void ByteBufferAsyncProcessor::trim_acknowledged()
 {
+	if (resending)
 	{
-		std::lock_guard<decltype(queue_lock)> guard(queue_lock);
+		// packages being resent are released once they are all sent
+		return;
+	}
 
-		logger->debug("{}: reprocessing started", id);
+	size_t released = 0;
+	while (current_seqn <= acknowledged_seqn && !pending_queue.empty())
+	{
+		released += pending_queue.front().size();
+		if (pool != nullptr)
+		{
+			pool->release(std::move(pending_queue.front()));
+		}
+		pending_queue.pop_front();
+		++current_seqn;
+	}
+	unacknowledged_bytes -= released;
 
+#if defined(RD_WIRE_STATS)
+	const auto now = std::chrono::steady_clock::now();
+	while (!sent_times.empty() && sent_times.front().first <= acknowledged_seqn)
+	{
+		ack_latency.record(now - sent_times.front().second);
+		sent_times.pop_front();
+	}
+#endif
+}
+
+void ByteBufferAsyncProcessor::collect_batch(std::deque<Buffer::ByteArray> const& source, size_t from)
+{
+	batch.clear();
+	size_t batch_bytes = 0;
+	for (auto it = source.begin() + from; it != source.end() && batch.size() < MAX_BATCH_PACKAGES; ++it)
+	{
+		if (!batch.empty() && batch_bytes + it->size() > MAX_BATCH_BYTES)
+		{
+			break;
+		}
+		batch.push_back(&*it);
+		batch_bytes += it->size();
+	}
+}
+
+bool ByteBufferAsyncProcessor::reprocess()
+{
+	bool success = true;
+	{
+		std::lock_guard<decltype(queue_lock)> guard(queue_lock);
 		std::unique_lock<decltype(processing_lock)> ul(processing_lock);
-		processing_cv.wait(ul, [this]() -> bool { return !in_processing; });
+		if (interrupt_balance != 0)
+		{
+			// paused again before the resend has started, the next resume requests it anew
+			return false;
+		}
+		util::bool_guard bool_guard(in_processing);
 
-		logger->debug("{}: reprocessing waited for main processing", id);
+		logger->debug("{}: reprocessing started", id);
 
-		while (current_seqn <= acknowledged_seqn)
+		size_t count;
 		{
-			pending_queue.pop_front();
-			++current_seqn;
+			std::lock_guard<decltype(pending_lock)> pending_guard(pending_lock);
+			trim_acknowledged();
+			// latency is measured from resending, time spent disconnected isn't counted
+			RD_WIRE_STATS_ONLY(sent_times.clear());
+			count = pending_queue.size();
+			resending = true;
 		}
-		for (int i = 0; i < pending_queue.size(); ++i)
+		// only this thread adds packages to pending_queue and acknowledges don't remove them while resending
+		for (size_t i = 0; i < count; i += batch.size())
 		{
-			auto const& item = pending_queue[i];
-			if (!processor(item, current_seqn + i))
 			{
-				return false;
+				std::lock_guard<decltype(pending_lock)> pending_guard(pending_lock);
+				collect_batch(pending_queue, i);
 			}
+			if (!processor(batch, current_seqn + i))
+			{
+				success = false;
+				break;
+			}
+#if defined(RD_WIRE_STATS)
+			std::lock_guard<decltype(pending_lock)> pending_guard(pending_lock);
+			sent_times.emplace_back(current_seqn + i + batch.size() - 1, std::chrono::steady_clock::now());
+#endif
 		}
+
+		std::lock_guard<decltype(pending_lock)> pending_guard(pending_lock);
+		resending = false;
+		trim_acknowledged();
 	}
-	return true;
+	processing_cv.notify_all();
+	return success;
 }
 
 void ByteBufferAsyncProcessor::process()
@@ -114,13 +218,31 @@ void ByteBufferAsyncProcessor::process()
 
 		logger->debug("{}: processing started", id);
 
-		while (!queue.empty() && processor(queue.front(), max_sent_seqn + 1))
+		// paused after the processing thread had been woken up, queue is sent after resume
+		while (!queue.empty() && interrupt_balance == 0)
 		{
-			++max_sent_seqn;
-			pending_queue.push_back(std::move(queue.front()));
-			queue.pop_front();
+			collect_batch(queue, 0);
+			if (!processor(batch, max_sent_seqn + 1))
+			{
+				break;
+			}
+			max_sent_seqn += batch.size();
+
+			std::lock_guard<decltype(pending_lock)> pending_guard(pending_lock);
+			for (size_t i = 0; i < batch.size(); ++i)
+			{
+				pending_queue.push_back(std::move(queue.front()));
+				queue.pop_front();
+			}
+			RD_WIRE_STATS_ONLY(sent_times.emplace_back(max_sent_seqn, std::chrono::steady_clock::now()));
 		}
 	}
+	{
+		// acknowledge may have arrived before the package was moved to pending_queue
+		std::lock_guard<decltype(lock)> guard(lock);
+		std::lock_guard<decltype(pending_lock)> pending_guard(pending_lock);
+		trim_acknowledged();
+	}
 	processing_cv.notify_all();
 
 	cv.notify_all();
@@ -134,20 +256,20 @@ void ByteBufferAsyncProcessor::ThreadProc()
 	while (true)
 	{
 		{
-			std::lock_guard<decltype(lock)> guard(lock);
+			std::unique_lock<decltype(incoming_lock)> guard(incoming_lock);
 
 			if (state >= StateKind::Terminated)
 			{
 				return;
 			}
 
-			while (data.empty() || interrupt_balance != 0)
+			while ((incoming.load() == nullptr && !reprocess_requested) || interrupt_balance != 0)
 			{
 				if (state >= StateKind::Stopping)
 				{
 					return;
 				}
-				cv.wait(lock);
+				incoming_cv.wait(guard);
 
 				logger->debug("{}'s ThreadProc waited for notify", id);
 
@@ -156,12 +278,16 @@ void ByteBufferAsyncProcessor::ThreadProc()
 					return;
 				}
 			}
-			add_data(std::move(data));
-			data.clear();
 		}
+		add_data(incoming.exchange(nullptr, std::memory_order_acquire));
 
 		try
 		{
+			// packages not acknowledged before reconnection go ahead of the new ones
+			if (reprocess_requested.exchange(false))
+			{
+				reprocess();
+			}
 			process();
 		}
 		catch (std::exception const& e)
@@ -200,16 +326,39 @@ bool ByteBufferAsyncProcessor::terminate(time_t timeout)
 
 void ByteBufferAsyncProcessor::put(Buffer::ByteArray new_data)
 {
+	if (state >= StateKind::Stopping)
 	{
-		std::lock_guard<decltype(lock)> guard(lock);
+		return;
+	}
+	const size_t max_bytes = max_unacknowledged_bytes;
+	const auto current_thread_id = std::this_thread::get_id();
+	if (max_bytes > 0 && unacknowledged_bytes >= max_bytes && current_thread_id != async_thread_id &&
+		current_thread_id != receiving_thread_id.load())
+	{
+		std::unique_lock<decltype(lock)> guard(lock);
 
+		logger->debug("{}: put is blocked until counterpart acknowledges {} bytes", id, unacknowledged_bytes.load());
+		cv.wait(guard, [this]() -> bool {
+			return state >= StateKind::Stopping || interrupt_balance != 0 || unacknowledged_bytes < max_unacknowledged_bytes;
+		});
 		if (state >= StateKind::Stopping)
 		{
 			return;
 		}
-		data.emplace_back(std::move(new_data));
 	}
-	cv.notify_all();
+	unacknowledged_bytes += new_data.size();
+
+	auto node = new IncomingNode{std::move(new_data), nullptr};
+	IncomingNode* head = incoming.load(std::memory_order_relaxed);
+	do
+	{
+		node->next = head;
+	} while (!incoming.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+	if (head == nullptr)
+	{
+		// processing thread may sleep only when there was nothing to drain
+		notify_processing_thread();
+	}
 }
 
 void ByteBufferAsyncProcessor::pause(const std::string& reason)
@@ -217,6 +366,8 @@ void ByteBufferAsyncProcessor::pause(const std::string& reason)
 	std::lock_guard<decltype(lock)> guard(lock);
 
 	++interrupt_balance;
+	// release producers waiting for acknowledges which won't come until reconnect
+	cv.notify_all();
 
 	logger->debug("{} paused with reason={},state={}", id, reason, to_string(state));
 
@@ -235,29 +386,62 @@ void ByteBufferAsyncProcessor::resume()
 	{
 		std::lock_guard<decltype(lock)> guard(lock);
 
-		reprocess();
-
+		// resent on the processing thread, resume() is called by receiving threads which mustn't block on sending
+		reprocess_requested = true;
 		--interrupt_balance;
 
 		logger->debug("{} resumed", id);
 	}
 
 	cv.notify_all();
+	notify_processing_thread();
 }
 
 void ByteBufferAsyncProcessor::acknowledge(sequence_number_t seqn)
 {
-	std::lock_guard<decltype(lock)> guard(lock);
-
-	if (seqn > acknowledged_seqn)
 	{
-		logger->trace("{}: new acknowledged seqn: {}", this->id, seqn);
-		acknowledged_seqn = seqn;
+		std::lock_guard<decltype(lock)> guard(lock);
+
+		if (seqn > acknowledged_seqn)
+		{
+			logger->trace("{}: new acknowledged seqn: {}", this->id, seqn);
+			acknowledged_seqn = seqn;
+
+			std::lock_guard<decltype(pending_lock)> pending_guard(pending_lock);
+			trim_acknowledged();
+		}
+		else
+		{
+			logger->error("Acknowledge {} called, while next seqn MUST BE greater than {}", seqn, acknowledged_seqn);
+			return;
+		}
 	}
-	else
+	cv.notify_all();
+}
+
+void ByteBufferAsyncProcessor::set_max_unacknowledged_bytes(size_t value)
+{
 	{
-		logger->error("Acknowledge {} called, while next seqn MUST BE greater than {}", seqn, acknowledged_seqn);
+		std::lock_guard<decltype(lock)> guard(lock);
+		max_unacknowledged_bytes = value;
 	}
+	cv.notify_all();
+}
+
+size_t ByteBufferAsyncProcessor::get_unacknowledged_bytes() const
+{
+	return unacknowledged_bytes;
+}
+
+void ByteBufferAsyncProcessor::set_receiving_thread(std::thread::id thread_id)
+{
+	receiving_thread_id = thread_id;
+}
+
+LatencyHistogram ByteBufferAsyncProcessor::get_ack_latency()
+{
+	std::lock_guard<decltype(pending_lock)> guard(pending_lock);
+	return ack_latency;
 }
 
 std::string to_string(ByteBufferAsyncProcessor::StateKind state)
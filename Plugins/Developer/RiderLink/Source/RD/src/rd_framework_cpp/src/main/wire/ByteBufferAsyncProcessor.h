@@ -7,6 +7,8 @@
 #endif
 
 #include "protocol/Buffer.h"
+#include "ByteArrayPool.h"
+#include "WireStats.h"
 #include "spdlog/spdlog.h"
 
 #include <chrono>
@@ -15,6 +17,8 @@
 #include <condition_variable>
 #include <future>
 #include <list>
+#include <atomic>
+#include <thread>
 
 #include <rd_framework_export.h>
 
@@ -25,6 +29,11 @@ using sequence_number_t = int64_t;
 class RD_FRAMEWORK_API ByteBufferAsyncProcessor
 {
 public:
+	/**
+	 * \brief Consecutive packages passed to the processor at once, the first one has the given sequence number.
+	 */
+	using batch_t = std::vector<Buffer::ByteArray const*>;
+
 	enum class StateKind
 	{
 		Initialized,
@@ -37,39 +46,85 @@ public:
 private:
 	using time_t = std::chrono::milliseconds;
 
-	static size_t INITIAL_CAPACITY;
+	static size_t DEFAULT_MAX_UNACKNOWLEDGED_BYTES;
+	static size_t MAX_BATCH_BYTES;
+	static size_t MAX_BATCH_PACKAGES;
 
 	std::recursive_mutex lock;
 	std::condition_variable_any cv;
 
 	std::string id;
 
-	std::function<bool(Buffer::ByteArray const&, sequence_number_t seqn)> processor;
+	std::function<bool(batch_t const&, sequence_number_t first_seqn)> processor;
+
+	ByteArrayPool* pool = nullptr;
 
-	StateKind state{StateKind::Initialized};
+	std::atomic<StateKind> state{StateKind::Initialized};
 	static std::shared_ptr<spdlog::logger> logger;
 
 	std::thread::id async_thread_id;
+	/**
+	 * \brief Thread acknowledges are received on, see [set_receiving_thread].
+	 */
+	std::atomic<std::thread::id> receiving_thread_id{};
 	std::future<void> async_future;
 
-	std::vector<Buffer::ByteArray> data;
+	/**
+	 * \brief Node of the lock-free stack [put] pushes to, drained by the processing thread in one exchange.
+	 */
+	struct IncomingNode
+	{
+		Buffer::ByteArray data;
+		IncomingNode* next;
+	};
+
+	std::atomic<IncomingNode*> incoming{nullptr};
+	std::mutex incoming_lock;
+	std::condition_variable incoming_cv;
+
 	std::mutex queue_lock;
 	std::deque<Buffer::ByteArray> queue{};
+	std::mutex pending_lock;
 	std::deque<Buffer::ByteArray> pending_queue{};
 
+	/**
+	 * \brief Last sequence number of each sent batch not acknowledged yet and the time it was sent at, filled only if
+	 * RD_WIRE_STATS is defined.
+	 */
+	std::deque<std::pair<sequence_number_t, std::chrono::steady_clock::time_point>> sent_times{};
+	LatencyHistogram ack_latency;
+
+	/**
+	 * \brief Total size of packages which were put but not acknowledged by counterpart yet.
+	 */
+	std::atomic<size_t> unacknowledged_bytes{0};
+	std::atomic<size_t> max_unacknowledged_bytes{DEFAULT_MAX_UNACKNOWLEDGED_BYTES};
+
 	sequence_number_t max_sent_seqn = 0;
 	sequence_number_t current_seqn = 1;
 	sequence_number_t acknowledged_seqn = 0;
 
-	int32_t interrupt_balance = 0;
+	std::atomic<int32_t> interrupt_balance{0};
+	/**
+	 * \brief Set by [resume], [pending_queue] is resent by the processing thread before the new packages.
+	 */
+	std::atomic<bool> reprocess_requested{false};
+	bool resending = false;
 	bool in_processing = false;
 	std::mutex processing_lock;
 	std::condition_variable processing_cv;
+	batch_t batch;
 
 public:
 	// region ctor/dtor
 
-	explicit ByteBufferAsyncProcessor(std::string id, std::function<bool(Buffer::ByteArray const&, sequence_number_t)> processor);
+	/**
+	 * \param pool receives packages back once they are acknowledged, may be null.
+	 */
+	explicit ByteBufferAsyncProcessor(
+		std::string id, std::function<bool(batch_t const&, sequence_number_t)> processor, ByteArrayPool* pool = nullptr);
+
+	~ByteBufferAsyncProcessor();
 
 	// endregion
 private:
@@ -77,7 +132,13 @@ private:
 
 	bool terminate0(time_t timeout, StateKind state_to_set, string_view action);
 
-	void add_data(std::vector<Buffer::ByteArray>&& new_data);
+	void notify_processing_thread();
+
+	void add_data(IncomingNode* new_data);
+
+	void trim_acknowledged();
+
+	void collect_batch(std::deque<Buffer::ByteArray> const& source, size_t from);
 
 	bool reprocess();
 
@@ -99,6 +160,25 @@ public:
 	void resume();
 
 	void acknowledge(int64_t seqn);
+
+	/**
+	 * \brief Sets the limit of not acknowledged bytes after which [put] blocks until counterpart acknowledges
+	 * sent packages. Zero means no limit. Doesn't apply while processor is paused.
+	 */
+	void set_max_unacknowledged_bytes(size_t value);
+
+	size_t get_unacknowledged_bytes() const;
+
+	/**
+	 * \brief [put] never blocks the thread acknowledges are received on, only that thread could release it. Handlers
+	 * invoked synchronously by the receiving thread, e.g. of RdExtBase, send from it.
+	 */
+	void set_receiving_thread(std::thread::id thread_id);
+
+	/**
+	 * \brief Empty unless RD_WIRE_STATS is defined.
+	 */
+	LatencyHistogram get_ack_latency();
 };
 
 std::string to_string(ByteBufferAsyncProcessor::StateKind state);
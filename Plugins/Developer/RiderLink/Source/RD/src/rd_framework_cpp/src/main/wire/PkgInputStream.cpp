@@ -31,15 +31,28 @@ Buffer& PkgInputStream::get_buffer()
 	return buffer;
 }
 
-int32_t PkgInputStream::try_read(Buffer::word_t* res, size_t size)
+constexpr size_t PkgInputStream::npos;
+
+bool PkgInputStream::request_if_read()
 {
-	if (memory == -1 || buffer.get_position() == memory)
+	if (memory == npos || buffer.get_position() == memory)
 	{
-		memory = request_data();
-		if (memory == -1)
+		const int32_t received = request_data();
+		if (received == -1)
 		{
-			return -1;
+			memory = npos;
+			return false;
 		}
+		memory = static_cast<size_t>(received);
+	}
+	return true;
+}
+
+int32_t PkgInputStream::try_read(Buffer::word_t* res, size_t size)
+{
+	if (!request_if_read())
+	{
+		return -1;
 	}
 	const int32_t n = static_cast<int32_t>((std::min)(size, memory - buffer.get_position()));
 	Buffer::word_t* start = buffer.current_pointer();
@@ -48,11 +61,32 @@ int32_t PkgInputStream::try_read(Buffer::word_t* res, size_t size)
 	return n;
 }
 
+int32_t PkgInputStream::fetch()
+{
+	if (!request_if_read())
+	{
+		return -1;
+	}
+	return static_cast<int32_t>(memory - buffer.get_position());
+}
+
+Buffer PkgInputStream::take_rest(size_t skip)
+{
+	auto& array = buffer.get_data();
+	array.resize(memory);
+	Buffer res(std::move(array), buffer.get_position() + skip);
+
+	buffer.get_data().clear();
+	buffer.rewind();
+	memory = 0;
+	return res;
+}
+
 bool PkgInputStream::read(Buffer::word_t* res, size_t size)
 {
 	//		spdlog::trace("PkgInputStream call: size={}, pos={}, memory={}", size, buffer.get_position(), memory);
 
-	int32_t summary_size = 0;
+	size_t summary_size = 0;
 	while (summary_size < size)
 	{
 		const int32_t bytes_read = try_read(res + summary_size, size - summary_size);
@@ -8,6 +8,8 @@
 
 #include "protocol/Buffer.h"
 
+#include <cstring>
+
 #include <rd_framework_export.h>
 
 namespace rd
@@ -19,8 +21,20 @@ private:
 
 	std::function<int32_t()> request_data;
 
+	/**
+	 * \brief Value of [memory] after the next package couldn't be received.
+	 */
+	static constexpr size_t npos = static_cast<size_t>(-1);
+
+	// size of the current package
 	size_t memory = 0;
 
+	/**
+	 * \brief Requests the next package if the current one has been read completely.
+	 * \return false if it couldn't be received.
+	 */
+	bool request_if_read();
+
 public:
 	template <typename F>
 	explicit PkgInputStream(F&& f) : request_data(std::forward<F>(f))
@@ -41,6 +55,26 @@ public:
 
 	bool read(Buffer::word_t* res, size_t size);
 
+	/**
+	 * \brief Requests the next package if the current one has been read completely.
+	 * \return number of bytes left in the current package or -1 if the next package couldn't be received.
+	 */
+	int32_t fetch();
+
+	/**
+	 * \brief Moves the rest of the current package out without copying.
+	 * \param skip number of bytes after the current position the result is positioned at.
+	 */
+	Buffer take_rest(size_t skip);
+
+	template <typename T>
+	T peek_integral(size_t offset) const
+	{
+		T x{};
+		std::memcpy(&x, buffer.current_pointer() + offset, sizeof(T));
+		return x;
+	}
+
 	template <typename T>
 	T read_integral()
 	{
@@ -0,0 +1,287 @@
+#include "SocketReactor.h"
+
+#if defined(RD_SOCKET_REACTOR)
+
+#include <util/core_util.h>
+#include <util/thread_util.h>
+
+#include "spdlog/sinks/stdout_color_sinks.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+namespace rd
+{
+std::shared_ptr<spdlog::logger> SocketReactor::logger =
+	spdlog::stderr_color_mt<spdlog::synchronous_factory>("socketReactorLog", spdlog::color_mode::automatic);
+
+constexpr SocketReactor::registration_t SocketReactor::INVALID_REGISTRATION;
+
+SocketReactor::SocketReactor()
+{
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	RD_ASSERT_THROW_MSG(epoll_fd != -1, fmt::format("SocketReactor: failed to create epoll, reason: {}", strerror(errno)));
+	wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	RD_ASSERT_THROW_MSG(wakeup_fd != -1, fmt::format("SocketReactor: failed to create eventfd, reason: {}", strerror(errno)));
+
+	epoll_event event{};
+	event.events = EPOLLIN;
+	event.data.u64 = INVALID_REGISTRATION;
+	RD_ASSERT_THROW_MSG(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wakeup_fd, &event) == 0,
+		fmt::format("SocketReactor: failed to watch eventfd, reason: {}", strerror(errno)));
+
+	thread = std::thread([this] { run(); });
+}
+
+SocketReactor::~SocketReactor()
+{
+	RD_ASSERT_MSG(!is_reactor_thread(), "SocketReactor can't be destroyed on its own thread, see release()");
+
+	stopped = true;
+	wakeup();
+	thread.join();
+	close(wakeup_fd);
+	close(epoll_fd);
+}
+
+std::shared_ptr<SocketReactor> SocketReactor::get()
+{
+	static std::mutex instance_lock;
+	static std::weak_ptr<SocketReactor> instance;
+
+	std::lock_guard<std::mutex> guard(instance_lock);
+	auto result = instance.lock();
+	if (result == nullptr)
+	{
+		result = std::shared_ptr<SocketReactor>(new SocketReactor(), &SocketReactor::release);
+		instance = result;
+	}
+	return result;
+}
+
+void SocketReactor::release(SocketReactor* reactor)
+{
+	if (reactor->is_reactor_thread())
+	{
+		// the last reference was dropped by a handler, the loop is still running on this thread and must be joined
+		std::thread([reactor] { delete reactor; }).detach();
+	}
+	else
+	{
+		delete reactor;
+	}
+}
+
+SocketReactor::registration_t SocketReactor::add(int fd, uint32_t events, std::function<void(uint32_t)> on_event)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	const registration_t registration = next_registration++;
+	auto entry = std::make_shared<Entry>();
+	entry->fd = fd;
+	entry->on_event = std::move(on_event);
+	entry->deadline = deadlines.end();
+
+	epoll_event event{};
+	event.events = events | EPOLLET;
+	event.data.u64 = static_cast<uint64_t>(registration);
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+	{
+		logger->error("SocketReactor: failed to watch fd {}, reason: {}", fd, strerror(errno));
+		return INVALID_REGISTRATION;
+	}
+	entries.emplace(registration, std::move(entry));
+	return registration;
+}
+
+SocketReactor::registration_t SocketReactor::add_timer(
+	clock_t::duration delay, clock_t::duration period, std::function<void()> on_timer)
+{
+	registration_t registration;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		registration = next_registration++;
+		auto entry = std::make_shared<Entry>();
+		entry->on_timer = std::move(on_timer);
+		entry->period = period;
+		entry->deadline = deadlines.emplace(clock_t::now() + delay, registration);
+		entries.emplace(registration, std::move(entry));
+	}
+	wakeup();
+	return registration;
+}
+
+void SocketReactor::remove(registration_t registration)
+{
+	if (registration == INVALID_REGISTRATION)
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> guard(lock);
+	auto it = entries.find(registration);
+	if (it != entries.end())
+	{
+		auto const& entry = it->second;
+		if (entry->fd != -1)
+		{
+			// fd may have been closed already, which removes it from epoll as well
+			epoll_ctl(epoll_fd, EPOLL_CTL_DEL, entry->fd, nullptr);
+		}
+		if (entry->deadline != deadlines.end())
+		{
+			deadlines.erase(entry->deadline);
+		}
+		entries.erase(it);
+	}
+	if (!is_reactor_thread())
+	{
+		idle_cv.wait(guard, [this, registration] { return running != registration; });
+	}
+}
+
+bool SocketReactor::is_reactor_thread() const
+{
+	return std::this_thread::get_id() == thread.get_id();
+}
+
+std::thread::id SocketReactor::get_thread_id() const
+{
+	return thread.get_id();
+}
+
+void SocketReactor::run()
+{
+	util::set_thread_name("SocketReactor");
+
+	std::array<epoll_event, 64> events;
+	while (!stopped)
+	{
+		const int count = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), next_timeout());
+		if (count == -1 && errno != EINTR)
+		{
+			logger->error("SocketReactor: epoll_wait failed, reason: {}", strerror(errno));
+			break;
+		}
+		for (int i = 0; i < count; ++i)
+		{
+			const auto registration = static_cast<registration_t>(events[i].data.u64);
+			if (registration == INVALID_REGISTRATION)
+			{
+				uint64_t value;
+				while (read(wakeup_fd, &value, sizeof(value)) > 0)
+				{
+				}
+				continue;
+			}
+			invoke(registration, events[i].events);
+		}
+		run_due_timers();
+	}
+}
+
+void SocketReactor::invoke(registration_t registration, uint32_t events)
+{
+	std::shared_ptr<Entry> entry;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		auto it = entries.find(registration);
+		if (it == entries.end())
+		{
+			// removed after epoll_wait had returned its event
+			return;
+		}
+		entry = it->second;
+		running = registration;
+	}
+
+	try
+	{
+		if (entry->on_event)
+		{
+			entry->on_event(events);
+		}
+		else
+		{
+			entry->on_timer();
+		}
+	}
+	catch (std::exception const& e)
+	{
+		logger->error("SocketReactor: handler {} failed | {}", registration, e.what());
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		running = INVALID_REGISTRATION;
+		if (entry->fd == -1 && entry->period == clock_t::duration::zero())
+		{
+			entries.erase(registration);
+		}
+	}
+	idle_cv.notify_all();
+}
+
+void SocketReactor::run_due_timers()
+{
+	std::vector<registration_t> due;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		const auto now = clock_t::now();
+		while (!deadlines.empty() && deadlines.begin()->first <= now)
+		{
+			const auto deadline = deadlines.begin()->first;
+			const auto registration = deadlines.begin()->second;
+			deadlines.erase(deadlines.begin());
+
+			auto const& entry = entries.at(registration);
+			if (entry->period != clock_t::duration::zero())
+			{
+				// timers don't catch up after the reactor has been busy for several periods
+				entry->deadline = deadlines.emplace((std::max)(deadline + entry->period, now), registration);
+			}
+			else
+			{
+				entry->deadline = deadlines.end();
+			}
+			due.push_back(registration);
+		}
+	}
+	for (const auto registration : due)
+	{
+		invoke(registration, 0);
+	}
+}
+
+int SocketReactor::next_timeout()
+{
+	std::lock_guard<std::mutex> guard(lock);
+	if (deadlines.empty())
+	{
+		return -1;
+	}
+	const auto left = deadlines.begin()->first - clock_t::now();
+	if (left <= clock_t::duration::zero())
+	{
+		return 0;
+	}
+	// round up, otherwise the reactor wakes up just before the deadline and spins
+	return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(left).count()) + 1;
+}
+
+void SocketReactor::wakeup()
+{
+	const uint64_t value = 1;
+	if (write(wakeup_fd, &value, sizeof(value)) == -1 && errno != EAGAIN)
+	{
+		logger->error("SocketReactor: failed to wake up, reason: {}", strerror(errno));
+	}
+}
+}	 // namespace rd
+
+#endif	  // RD_SOCKET_REACTOR
@@ -0,0 +1,121 @@
+#ifndef RD_CPP_SOCKETREACTOR_H
+#define RD_CPP_SOCKETREACTOR_H
+
+// define RD_DISABLE_SOCKET_REACTOR to give every SocketWire threads of its own like on other platforms
+#if defined(__linux__) && !defined(RD_DISABLE_SOCKET_REACTOR)
+#define RD_SOCKET_REACTOR 1
+#endif
+
+#if defined(RD_SOCKET_REACTOR)
+
+#include "spdlog/spdlog.h"
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <unordered_map>
+#include <atomic>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Multiplexes readiness of any number of sockets and periodic timers on a single thread using edge-triggered epoll.
+ * Handlers must not block, they are invoked on the reactor thread one at a time.
+ */
+class RD_FRAMEWORK_API SocketReactor
+{
+public:
+	using registration_t = int64_t;
+	using clock_t = std::chrono::steady_clock;
+
+	static constexpr registration_t INVALID_REGISTRATION = 0;
+
+private:
+	static std::shared_ptr<spdlog::logger> logger;
+
+	struct Entry
+	{
+		int fd = -1;
+		std::function<void(uint32_t)> on_event;
+		std::function<void()> on_timer;
+		clock_t::duration period{};
+		std::multimap<clock_t::time_point, registration_t>::iterator deadline;
+	};
+
+	int epoll_fd = -1;
+	int wakeup_fd = -1;
+
+	std::mutex lock;
+	std::condition_variable idle_cv;
+	std::unordered_map<registration_t, std::shared_ptr<Entry>> entries;
+	std::multimap<clock_t::time_point, registration_t> deadlines;
+	registration_t next_registration = 1;
+	registration_t running = INVALID_REGISTRATION;
+
+	std::atomic<bool> stopped{false};
+	std::thread thread;
+
+	void run();
+
+	void invoke(registration_t registration, uint32_t events);
+
+	void run_due_timers();
+
+	int next_timeout();
+
+	void wakeup();
+
+	/**
+	 * \brief Deleter of the shared instance, which is destroyed on another thread if released by a handler.
+	 */
+	static void release(SocketReactor* reactor);
+
+public:
+	// region ctor/dtor
+
+	SocketReactor();
+
+	SocketReactor(SocketReactor const&) = delete;
+
+	SocketReactor& operator=(SocketReactor const&) = delete;
+
+	virtual ~SocketReactor();
+
+	// endregion
+
+	/**
+	 * \brief Reactor shared by all its current users, its thread stops once the last reference is released.
+	 */
+	static std::shared_ptr<SocketReactor> get();
+
+	/**
+	 * \brief Starts watching [fd] for [events] (EPOLLIN, EPOLLOUT...), notifications are edge-triggered.
+	 */
+	registration_t add(int fd, uint32_t events, std::function<void(uint32_t)> on_event);
+
+	/**
+	 * \brief Invokes [on_timer] after [delay] and then every [period] unless it's zero.
+	 */
+	registration_t add_timer(clock_t::duration delay, clock_t::duration period, std::function<void()> on_timer);
+
+	/**
+	 * \brief Stops notifications of [registration]. When called from another thread, waits for the running handler
+	 * of [registration] to finish.
+	 */
+	void remove(registration_t registration);
+
+	bool is_reactor_thread() const;
+
+	std::thread::id get_thread_id() const;
+};
+}	 // namespace rd
+
+#endif	  // RD_SOCKET_REACTOR
+
+#endif	  // RD_CPP_SOCKETREACTOR_H
@@ -1,6 +1,7 @@
 #include "wire/SocketWire.h"
 
 #include <util/thread_util.h>
+#include <util/compression.h>
 
 #include "spdlog/sinks/stdout_color_sinks.h"
 
@@ -11,6 +12,20 @@
 #include <utility>
 #include <thread>
 #include <csignal>
+#include <cstring>
+
+#if defined(RD_SOCKET_REACTOR)
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#endif
+
+#if defined(RD_UNIX_SOCKET)
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
 
 namespace rd
 {
@@ -22,6 +37,18 @@ std::chrono::milliseconds SocketWire::timeout = std::chrono::milliseconds(500);
 constexpr int32_t SocketWire::Base::ACK_MESSAGE_LENGTH;
 constexpr int32_t SocketWire::Base::PING_MESSAGE_LENGTH;
 constexpr int32_t SocketWire::Base::PACKAGE_HEADER_LENGTH;
+constexpr size_t SocketWire::Base::INITIAL_SEND_BUFFER_SIZE;
+constexpr int32_t SocketWire::Base::DIRECT_RECEIVE_THRESHOLD;
+constexpr int32_t SocketWire::Base::COMPRESSED_MESSAGE_LENGTH;
+constexpr int32_t SocketWire::Base::COMPRESSED_PACKAGE_HEADER_LENGTH;
+constexpr sequence_number_t SocketWire::Base::COMPRESSION_SUPPORTED_SEQN;
+constexpr int32_t SocketWire::Base::VARINT_MESSAGE_FLAG;
+constexpr sequence_number_t SocketWire::Base::VARINT_SUPPORTED_SEQN;
+constexpr size_t SocketWire::Base::SEND_VECTOR_PACKAGES;
+#if defined(RD_SOCKET_REACTOR)
+constexpr sequence_number_t SocketWire::Base::NO_REQUESTED_ACK;
+constexpr int32_t SocketWire::Base::MESSAGE_HEADER_LENGTH;
+#endif
 
 SocketWire::Base::Base(std::string id, Lifetime parentLifetime, IScheduler* scheduler)
 	: WireBase(scheduler), id(std::move(id)), scheduler(scheduler), lifetimeDef(parentLifetime)
@@ -29,6 +56,7 @@ SocketWire::Base::Base(std::string id, Lifetime parentLifetime, IScheduler* sche
 	async_send_buffer.pause("initial");
 	async_send_buffer.start();
 	ping_pkg_header.write_integral(PING_MESSAGE_LENGTH);
+	compressed_packages.resize(SEND_VECTOR_PACKAGES);
 }
 
 SocketWire::Base::~Base()
@@ -68,31 +96,113 @@ void SocketWire::Base::receiverProc() const
 	}
 }
 
-bool SocketWire::Base::send0(Buffer::ByteArray const& msg, sequence_number_t seqn) const
+/**
+ * \brief Writes the whole [vector] to [socket], retrying after partial writes.
+ */
+static bool send_vector(CSimpleSocket* socket, iovec* vector, int32_t count)
+{
+	while (count > 0)
+	{
+		int32_t sent = socket->Send(vector, count);
+		if (sent <= 0)
+		{
+			if (sent == -1 && socket->GetSocketError() == CSimpleSocket::SocketInterrupted)
+			{
+				continue;
+			}
+			return false;
+		}
+		while (count > 0 && static_cast<size_t>(sent) >= vector->iov_len)
+		{
+			sent -= static_cast<int32_t>(vector->iov_len);
+			++vector;
+			--count;
+		}
+		if (count > 0)
+		{
+			vector->iov_base = static_cast<uint8_t*>(vector->iov_base) + sent;
+			vector->iov_len -= sent;
+		}
+	}
+	return true;
+}
+
+bool SocketWire::Base::send0(ByteBufferAsyncProcessor::batch_t const& packages, sequence_number_t first_seqn) const
 {
 	try
 	{
-		std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
+		std::unique_lock<decltype(socket_send_lock)> guard(socket_send_lock);
+#if defined(RD_SOCKET_REACTOR)
+		// acks and pings partially sent by the reactor must be completed first
+		send_control(true);
+#endif
+
+		const int32_t threshold = counterpart_supports_compression ? compression_threshold.load() : 0;
+
+		std::array<iovec, 2 * SEND_VECTOR_PACKAGES> vector;
+		std::array<size_t, SEND_VECTOR_PACKAGES + 1> header_offsets;
+		for (size_t from = 0; from < packages.size(); from += SEND_VECTOR_PACKAGES)
+		{
+			const size_t count = (std::min)(SEND_VECTOR_PACKAGES, packages.size() - from);
 
-		int32_t msglen = static_cast<int32_t>(msg.size());
+			send_package_header.rewind();
+			for (size_t i = 0; i < count; ++i)
+			{
+				auto const& msg = *packages[from + i];
+				const auto seqn = static_cast<sequence_number_t>(first_seqn + from + i);
+				header_offsets[i] = send_package_header.get_position();
+
+				size_t compressed_size = 0;
+				if (threshold > 0 && msg.size() >= static_cast<size_t>(threshold) &&
+					msg.size() > COMPRESSED_PACKAGE_HEADER_LENGTH - PACKAGE_HEADER_LENGTH)
+				{
+					// compressed package is sent only if it's smaller including its longer header
+					auto& compressed = compressed_packages[i];
+					compressed.resize(msg.size());
+					compressed_size = util::lz4_compress(msg.data(), msg.size(), compressed.data(),
+						msg.size() - (COMPRESSED_PACKAGE_HEADER_LENGTH - PACKAGE_HEADER_LENGTH));
+				}
 
-		send_package_header.rewind();
-		send_package_header.write_integral(msglen);
-		send_package_header.write_integral(seqn);
+				if (compressed_size > 0)
+				{
+					send_package_header.write_integral(COMPRESSED_MESSAGE_LENGTH);
+					send_package_header.write_integral(seqn);
+					send_package_header.write_integral(static_cast<int32_t>(compressed_size));
+					send_package_header.write_integral(static_cast<int32_t>(msg.size()));
+					vector[2 * i + 1].iov_base = compressed_packages[i].data();
+					vector[2 * i + 1].iov_len = compressed_size;
+				}
+				else
+				{
+					send_package_header.write_integral(static_cast<int32_t>(msg.size()));
+					send_package_header.write_integral(seqn);
+					vector[2 * i + 1].iov_base = const_cast<Buffer::word_t*>(msg.data());
+					vector[2 * i + 1].iov_len = msg.size();
+				}
+			}
+			header_offsets[count] = send_package_header.get_position();
 
-		RD_ASSERT_THROW_MSG(
-			socket_provider->Send(send_package_header.data(), send_package_header.get_position()) == PACKAGE_HEADER_LENGTH,
-			this->id +
-				": failed to send header over the network"
-				", reason: " +
-				socket_provider->DescribeError())
+			size_t total = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				vector[2 * i].iov_base = send_package_header.data() + header_offsets[i];
+				vector[2 * i].iov_len = header_offsets[i + 1] - header_offsets[i];
+				total += vector[2 * i].iov_len + vector[2 * i + 1].iov_len;
+			}
 
-		RD_ASSERT_THROW_MSG(socket_provider->Send(msg.data(), msglen) == msglen, this->id +
-																					 ": failed to send package over the network"
-																					 ", reason: " +
-																					 socket_provider->DescribeError());
-		logger->info("{}: were sent {} bytes", this->id, msglen);
+			RD_ASSERT_THROW_MSG(send_vector(socket_provider.get(), vector.data(), static_cast<int32_t>(2 * count)),
+				this->id +
+					": failed to send packages over the network"
+					", reason: " +
+					socket_provider->DescribeError());
+			logger->info("{}: were sent {} packages, {} bytes", this->id, count, total);
+			RD_WIRE_STATS_ONLY(packages_sent += count; bytes_sent += total);
+		}
 		//        RD_ASSERT_MSG(socketProvider->Flush(), "{}: failed to flush");
+#if defined(RD_SOCKET_REACTOR)
+		guard.unlock();
+		flush_control();
+#endif
 		return true;
 	}
 	catch (std::exception const& e)
@@ -103,21 +213,51 @@ bool SocketWire::Base::send0(Buffer::ByteArray const& msg, sequence_number_t seq
 	}
 }
 
-void SocketWire::Base::send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const
+void SocketWire::Base::write_message(
+	Buffer& buffer, RdId const& rd_id, bool varint_integrals, std::function<void(Buffer& buffer)> const& writer)
 {
 	RD_ASSERT_MSG(!rd_id.isNull(), "{}: id mustn't be null");
 
-	Buffer local_send_buffer;
-	local_send_buffer.write_integral<int32_t>(0);	 // placeholder for length
-	rd_id.write(local_send_buffer);					 // write id
-	local_send_buffer.write_integral<int16_t>(0);	 // placeholder for context
-	writer(local_send_buffer);						 // write rest
+	const size_t start = buffer.get_position();
+	buffer.write_integral<int32_t>(0);	  // placeholder for length
+	rd_id.write(buffer);				  // write id
+	buffer.write_integral<int16_t>(0);	  // placeholder for context
+	buffer.set_varint_integrals(varint_integrals);
+	writer(buffer);						  // write rest, may switch the mode to the one of copied bytes
+
+	const size_t end = buffer.get_position();
+
+	int32_t length = static_cast<int32_t>(end - start - 4);
+	if (buffer.varint_integrals())
+	{
+		length |= VARINT_MESSAGE_FLAG;
+	}
+	buffer.set_position(start);
+	buffer.write_integral<int32_t>(length);
+	buffer.set_position(end);
+}
+
+void SocketWire::Base::send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const
+{
+	Buffer local_send_buffer(send_buffer_pool.acquire(INITIAL_SEND_BUFFER_SIZE));
+	write_message(local_send_buffer, rd_id, varint_integrals(), writer);
+	async_send_buffer.put(std::move(local_send_buffer).getRealArray());
+}
 
-	int32_t len = static_cast<int32_t>(local_send_buffer.get_position());
+void SocketWire::Base::send_batch(std::vector<std::pair<RdId, std::function<void(Buffer& buffer)>>> const& messages) const
+{
+	if (messages.empty())
+	{
+		return;
+	}
 
-	local_send_buffer.rewind();
-	local_send_buffer.write_integral<int32_t>(len - 4);
-	local_send_buffer.set_position(len);
+	Buffer local_send_buffer(send_buffer_pool.acquire(INITIAL_SEND_BUFFER_SIZE));
+	const bool varint = varint_integrals();
+	for (auto const& message : messages)
+	{
+		write_message(local_send_buffer, message.first, varint, message.second);
+	}
+	// counterpart reads messages from the stream of packages, any number of them may share a package
 	async_send_buffer.put(std::move(local_send_buffer).getRealArray());
 }
 
@@ -126,6 +266,11 @@ void SocketWire::Base::set_socket_provider(std::shared_ptr<CActiveSocket> new_so
 	{
 		std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
 		socket_provider = std::move(new_socket);
+		// compression and varint integrals are negotiated per connection
+		counterpart_supports_compression = false;
+		compression_announced = false;
+		counterpart_supports_varint = false;
+		varint_announced = false;
 		socket_send_var.notify_all();
 	}
 	{
@@ -139,6 +284,8 @@ void SocketWire::Base::set_socket_provider(std::shared_ptr<CActiveSocket> new_so
 	auto heartbeat = LifetimeDefinition::use([this](Lifetime heartbeatLifetime) {
 		const auto heartbeat = start_heartbeat(heartbeatLifetime).share();
 
+		// acknowledges are read by this thread, it can't wait for them
+		async_send_buffer.set_receiving_thread(std::this_thread::get_id());
 		async_send_buffer.resume();
 
 		connected.set(true);
@@ -201,12 +348,15 @@ bool SocketWire::Base::read_from_socket(Buffer::word_t* res, int32_t msglen) con
 		}
 		else
 		{
-			if (hi == receiver_buffer.end())
+			// large reads don't need to go through receiver_buffer
+			const bool direct = rest >= DIRECT_RECEIVE_THRESHOLD;
+			if (!direct && hi == receiver_buffer.end())
 			{
 				hi = lo = receiver_buffer.begin();
 			}
 			logger->info("{}: receive started", this->id);
-			int32_t read = socket_provider->Receive(static_cast<int32_t>(receiver_buffer.end() - hi), &*hi);
+			int32_t read = direct ? socket_provider->Receive(rest, res + ptr)
+								  : socket_provider->Receive(static_cast<int32_t>(receiver_buffer.end() - hi), &*hi);
 			if (read == -1)
 			{
 				auto err = socket_provider->GetSocketError();
@@ -223,7 +373,14 @@ bool SocketWire::Base::read_from_socket(Buffer::word_t* res, int32_t msglen) con
 				logger->info("{}: socket was shut down for receiving", this->id);
 				return false;
 			}
-			hi += read;
+			if (direct)
+			{
+				ptr += read;
+			}
+			else
+			{
+				hi += read;
+			}
 			if (read > 0)
 			{
 				logger->info("{}: receive finished: {} bytes read", this->id, read);
@@ -263,25 +420,7 @@ std::pair<int, sequence_number_t> SocketWire::Base::read_header() const
 				return INVALID_HEADER;
 			}
 
-			counterpart_timestamp = received_timestamp;
-			counterpart_acknowledge_timestamp = received_counterpart_timestamp;
-
-			if ((connection_established(current_timestamp, counterpart_acknowledge_timestamp)))
-			{
-				if (!heartbeatAlive.get())
-				{	 // only on change
-					logger->trace(
-						"Connection is alive after receiving PING {}: "
-						"received_timestamp: {}, "
-						"received_counterpart_timestamp: {}, "
-						"current_timestamp: {}, "
-						"counterpart_timestamp: {}, "
-						"counterpart_acknowledge_timestamp: {}, ",
-						id, received_timestamp, received_counterpart_timestamp, current_timestamp, counterpart_timestamp,
-						counterpart_acknowledge_timestamp);
-				}
-				heartbeatAlive.set(true);
-			}
+			on_ping(received_timestamp, received_counterpart_timestamp);
 			continue;
 		}
 		if (!read_integral_from_socket(seqn))
@@ -291,52 +430,179 @@ std::pair<int, sequence_number_t> SocketWire::Base::read_header() const
 
 		if (len == ACK_MESSAGE_LENGTH)
 		{
-			async_send_buffer.acknowledge(seqn);
+			on_ack(seqn);
 			continue;
 		}
 		return std::make_pair(len, seqn);
 	}
 }
 
-int32_t SocketWire::Base::read_package() const
+void SocketWire::Base::on_ping(int32_t received_timestamp, int32_t received_counterpart_timestamp) const
 {
-	receive_pkg.rewind();
+	counterpart_timestamp = received_timestamp;
+	counterpart_acknowledge_timestamp = received_counterpart_timestamp;
 
-	const auto pair = read_header();
-	if (pair == INVALID_HEADER)
+	if ((connection_established(current_timestamp, counterpart_acknowledge_timestamp)))
 	{
-		logger->debug("{}: failed to read header", this->id);
-		return -1;
+		if (!heartbeatAlive.get())
+		{	 // only on change
+			logger->trace(
+				"Connection is alive after receiving PING {}: "
+				"received_timestamp: {}, "
+				"received_counterpart_timestamp: {}, "
+				"current_timestamp: {}, "
+				"counterpart_timestamp: {}, "
+				"counterpart_acknowledge_timestamp: {}, ",
+				id, received_timestamp, received_counterpart_timestamp, current_timestamp, counterpart_timestamp,
+				counterpart_acknowledge_timestamp);
+		}
+		heartbeatAlive.set(true);
+	}
+	if (compression_threshold > 0 && !compression_announced)
+	{
+		compression_announced = true;
+		send_ack(COMPRESSION_SUPPORTED_SEQN);
+	}
+	if (varint_enabled && !varint_announced)
+	{
+		varint_announced = true;
+		send_ack(VARINT_SUPPORTED_SEQN);
+	}
+}
+
+void SocketWire::Base::on_ack(sequence_number_t seqn) const
+{
+	if (seqn == COMPRESSION_SUPPORTED_SEQN)
+	{
+		logger->debug("{}: counterpart supports compressed packages", this->id);
+		counterpart_supports_compression = true;
+		return;
+	}
+	if (seqn == VARINT_SUPPORTED_SEQN)
+	{
+		logger->debug("{}: counterpart supports varint integrals", this->id);
+		counterpart_supports_varint = true;
+		return;
 	}
-	const auto len = pair.first;
-	const auto seqn = pair.second;
+	async_send_buffer.acknowledge(seqn);
+}
 
-	logger->debug("{}: read len={}, seqn={}, max_received_seqn={}", this->id, len, seqn, max_received_seqn);
+int32_t SocketWire::Base::read_package() const
+{
+	while (true)
+	{
+		receive_pkg.rewind();
 
-	receive_pkg.require_available(len);
-	if (!read_data_from_socket(receive_pkg.data(), len))
+		const auto pair = read_header();
+		if (pair == INVALID_HEADER)
+		{
+			logger->debug("{}: failed to read header", this->id);
+			return -1;
+		}
+		auto len = pair.first;
+		const auto seqn = pair.second;
+
+		logger->debug("{}: read len={}, seqn={}, max_received_seqn={}", this->id, len, seqn, max_received_seqn);
+
+		if (len == COMPRESSED_MESSAGE_LENGTH)
+		{
+			len = read_compressed_package();
+			if (len == -1)
+			{
+				return -1;
+			}
+		}
+		else
+		{
+			receive_pkg.require_available(len);
+			if (!read_data_from_socket(receive_pkg.data(), len))
+			{
+				logger->debug("{}: failed to read package", this->id);
+				return -1;
+			}
+		}
+		send_ack(seqn);
+		if (seqn <= max_received_seqn && seqn != 1)
+		{
+			// resent after reconnect, but has already been received
+			logger->debug("{}: skipped duplicate package, seqn={}", this->id, seqn);
+			continue;
+		}
+		max_received_seqn = seqn;
+
+		logger->info("{}: was received package, bytes={}, seqn={}", this->id, len, seqn);
+		RD_WIRE_STATS_ONLY(++packages_received; bytes_received += len);
+		return len;
+	}
+}
+
+int32_t SocketWire::Base::read_compressed_package() const
+{
+	int32_t compressed_len = 0;
+	int32_t len = 0;
+	if (!read_integral_from_socket(compressed_len) || !read_integral_from_socket(len))
 	{
-		logger->debug("{}: failed to read package", this->id);
+		logger->debug("{}: failed to read compressed package header", this->id);
 		return -1;
 	}
-	send_ack(seqn);
-	if (seqn <= max_received_seqn && seqn != 1)
+	if (compressed_len < 0 || len < 0)
 	{
-		return true;
+		logger->error("{}: invalid compressed package header, compressed={}, raw={}", this->id, compressed_len, len);
+		return -1;
+	}
+
+	compressed_receive_buffer.resize(compressed_len);
+	if (!read_data_from_socket(compressed_receive_buffer.data(), compressed_len))
+	{
+		logger->debug("{}: failed to read compressed package", this->id);
+		return -1;
 	}
-	max_received_seqn = seqn;
 
-	logger->info("{}: was received package, bytes={}, seqn={}", this->id, len, seqn);
+	receive_pkg.require_available(len);
+	if (!util::lz4_decompress(compressed_receive_buffer.data(), compressed_len, receive_pkg.data(), len))
+	{
+		logger->error("{}: failed to decompress package, compressed={}, raw={}", this->id, compressed_len, len);
+		return -1;
+	}
 	return len;
 }
 
 bool SocketWire::Base::read_and_dispatch_message() const
 {
-	sz = (sz == -1 ? receive_pkg.read_integral<int32_t>() : sz);
 	if (sz == -1)
 	{
-		logger->debug("{}: sz == -1", this->id);
-		return false;
+		// package holding exactly one message is dispatched as is, without copying it to [message]
+		const int32_t available = receive_pkg.fetch();
+		if (available == -1)
+		{
+			logger->debug("{}: sz == -1", this->id);
+			return false;
+		}
+		constexpr int32_t message_header_length = sizeof(int32_t) + sizeof(RdId::hash_t);
+		const int32_t length = available >= message_header_length ? receive_pkg.peek_integral<int32_t>(0) : -1;
+		if (length != -1 && (length & ~VARINT_MESSAGE_FLAG) + static_cast<int32_t>(sizeof(int32_t)) == available)
+		{
+			const RdId rd_id{receive_pkg.peek_integral<RdId::hash_t>(sizeof(int32_t))};
+			logger->trace("{}: message info: sz={}, id={}", this->id, available - sizeof(int32_t), rd_id.get_hash());
+
+			Buffer whole = receive_pkg.take_rest(message_header_length);
+			whole.set_varint_integrals((length & VARINT_MESSAGE_FLAG) != 0);
+			message_broker.dispatch(rd_id, std::move(whole));
+			RD_WIRE_STATS_ONLY(++messages_received);
+			logger->debug("{}: message dispatched", this->id);
+			return true;
+		}
+	}
+	if (sz == -1)
+	{
+		sz = receive_pkg.read_integral<int32_t>();
+		if (sz == -1)
+		{
+			logger->debug("{}: sz == -1", this->id);
+			return false;
+		}
+		message.set_varint_integrals((sz & VARINT_MESSAGE_FLAG) != 0);
+		sz &= ~VARINT_MESSAGE_FLAG;
 	}
 	id_ = (id_ == -1 ? receive_pkg.read_integral<RdId::hash_t>() : id_);
 	if (id_ == -1)
@@ -357,6 +623,7 @@ bool SocketWire::Base::read_and_dispatch_message() const
 
 	logger->debug("{}: message received", this->id);
 	message_broker.dispatch(rd_id, std::move(message));
+	RD_WIRE_STATS_ONLY(++messages_received);
 	logger->debug("{}: message dispatched", this->id);
 
 	sz = -1;
@@ -386,6 +653,17 @@ void SocketWire::Base::ping() const
 		}
 		heartbeatAlive.set(false);
 	}
+#if defined(RD_SOCKET_REACTOR)
+	{
+		std::lock_guard<decltype(control_lock)> guard(control_lock);
+		control_queue.write_integral(PING_MESSAGE_LENGTH);
+		control_queue.write_integral(current_timestamp);
+		control_queue.write_integral(counterpart_timestamp);
+		control_requested = true;
+	}
+	++current_timestamp;
+	flush_control();
+#else
 	try
 	{
 		ping_pkg_header.set_position(sizeof(PING_MESSAGE_LENGTH));
@@ -409,11 +687,22 @@ void SocketWire::Base::ping() const
 	{
 		logger->debug("{}: exception raised during PING | {}", this->id, e.what());
 	}
+#endif
 }
 
 bool SocketWire::Base::send_ack(sequence_number_t seqn) const
 {
 	logger->trace("{} send ack {}", id, seqn);
+#if defined(RD_SOCKET_REACTOR)
+	{
+		std::lock_guard<decltype(control_lock)> guard(control_lock);
+		control_queue.write_integral(ACK_MESSAGE_LENGTH);
+		control_queue.write_integral(seqn);
+		control_requested = true;
+	}
+	flush_control();
+	return true;
+#else
 	try
 	{
 		ack_buffer.rewind();
@@ -434,6 +723,7 @@ bool SocketWire::Base::send_ack(sequence_number_t seqn) const
 		logger->warn("{}: exception raised during ACK, seqn = {} | {}", id, seqn, e.what());
 		return false;
 	}
+#endif
 }
 
 bool SocketWire::Base::try_shutdown_connection() const
@@ -445,133 +735,964 @@ bool SocketWire::Base::try_shutdown_connection() const
 	return s->Shutdown(CSimpleSocket::Both);
 }
 
-SocketWire::Client::Client(Lifetime parentLifetime, IScheduler* scheduler, uint16_t port, const std::string& id)
-	: Base(id, parentLifetime, scheduler), port(port), clientLifetimeDefinition(parentLifetime)
+void SocketWire::Base::set_max_unacknowledged_bytes(size_t value) const
 {
-	Lifetime lifetime = clientLifetimeDefinition.lifetime;
-	thread = std::thread([this, lifetime]() mutable {
-		rd::util::set_thread_name(this->id.empty() ? "SocketWire::Client Thread" : this->id.c_str());
+	async_send_buffer.set_max_unacknowledged_bytes(value);
+}
 
-		try
-		{
-			logger->info("{}: started, port: {}.", this->id, this->port);
+ByteArrayPool::Stats SocketWire::Base::get_send_buffer_pool_stats() const
+{
+	return send_buffer_pool.get_stats();
+}
 
-			while (!lifetime->is_terminated())
-			{
-				try
-				{
-					socket = std::make_shared<CActiveSocket>();
-					RD_ASSERT_THROW_MSG(socket->Initialize(),
-						fmt::format("{}: failed to init ActiveSocket, reason: {}", this->id, socket->DescribeError()));
-					RD_ASSERT_THROW_MSG(socket->DisableNagleAlgoritm(),
-						fmt::format("{}: failed to DisableNagleAlgoritm, reason: {}", this->id, socket->DescribeError()));
-
-					// On windows connect will try to send SYN 3 times with interval of 500ms (total time is 1second)
-					// Connect timeout doesn't work if it's more than 1 second. But we don't need it because we can close socket any
-					// moment.
-
-					// https://stackoverflow.com/questions/22417228/prevent-tcp-socket-connection-retries
-					// HKLM\SYSTEM\CurrentControlSet\Services\Tcpip\Parameters\TcpMaxConnectRetransmissions
-					logger->info("{}: connecting 127.0.0.1: {}", this->id, this->port);
-					RD_ASSERT_THROW_MSG(socket->Open("127.0.0.1", this->port),
-						fmt::format("{}: failed to open ActiveSocket, reason: {}", this->id, socket->DescribeError()));
-					{
-						std::lock_guard<decltype(lock)> guard(lock);
-						if (lifetime->is_terminated())
-						{
-							if (!socket->Close())
-							{
-								logger->error("{} failed to close socket, reason: {}", this->id, socket->DescribeError());
-							}
-							return;
-						}
-					}
+WireStats SocketWire::Base::get_stats() const
+{
+	WireStats stats;
+	stats.packages_sent = packages_sent;
+	stats.bytes_sent = bytes_sent;
+	stats.packages_received = packages_received;
+	stats.bytes_received = bytes_received;
+	stats.messages_received = messages_received;
+	stats.ack_latency = async_send_buffer.get_ack_latency();
+	stats.send_buffer_pool = send_buffer_pool.get_stats();
+	return stats;
+}
 
-					set_socket_provider(socket);
-				}
-				catch (std::exception const& e)
-				{
-					logger->debug("{}: connection error for port {} ({}).", this->id, this->port, e.what());
+void SocketWire::Base::set_compression_threshold(int32_t threshold) const
+{
+	compression_threshold = threshold;
+}
 
-					std::lock_guard<decltype(lock)> guard(lock);
-					bool should_reconnect = false;
-					if (!lifetime->is_terminated())
-					{
-						cv.wait_for(lock, timeout);
-						should_reconnect = !lifetime->is_terminated();
-					}
-					if (should_reconnect)
-					{
-						continue;
-					}
-					break;
-				}
-			}
-		}
-		catch (std::exception const& e)
-		{
-			logger->info("{}: closed with exception: {}", this->id, e.what());
-		}
-		logger->info("{}: terminated, port: {}.", this->id, this->port);
-	});
+void SocketWire::Base::set_varint_integrals(bool enabled) const
+{
+	varint_enabled = enabled;
+}
 
-	lifetime->add_action([this]() {
-		logger->info("{}: starts terminating lifetime", this->id);
+bool SocketWire::Base::varint_integrals() const
+{
+	return varint_enabled && counterpart_supports_varint;
+}
 
-		const bool send_buffer_stopped = async_send_buffer.stop(timeout);
-		logger->debug("{}: send buffer stopped, success: {}", this->id, send_buffer_stopped);
+#if defined(RD_SOCKET_REACTOR)
+void SocketWire::Base::start_receiving(std::shared_ptr<CActiveSocket> new_socket)
+{
+	{
+		std::lock_guard<decltype(socket_send_lock)> guard(socket_send_lock);
+		socket_provider = std::move(new_socket);
+		// compression and varint integrals are negotiated per connection
+		counterpart_supports_compression = false;
+		compression_announced = false;
+		counterpart_supports_varint = false;
+		varint_announced = false;
+		control_sending.rewind();
+		control_sent = 0;
+		socket_send_var.notify_all();
+	}
+	{
+		std::lock_guard<decltype(control_lock)> guard(control_lock);
+		control_queue.rewind();
+		requested_ack = NO_REQUESTED_ACK;
+		control_requested = false;
+	}
+	// partially received package of the previous connection is going to be resent
+	lo = hi = receiver_buffer.begin();
+	receive_len = -1;
 
-		{
-			std::lock_guard<decltype(lock)> guard(lock);
-			logger->debug("{}: closing socket", this->id);
+	// acknowledges are read by the reactor thread, it can't wait for them
+	async_send_buffer.set_receiving_thread(reactor->get_thread_id());
+	async_send_buffer.resume();
 
-			if (socket != nullptr)
-			{
-				if (!socket->Close())
-				{
-					logger->error("{}: failed to close socket", this->id);
-				}
-			}
-		}
-		cv.notify_all();
+	connected.set(true);
 
-		logger->debug("{}: waiting for receiver thread", this->id);
-		logger->debug("{}: is thread joinable? {}", this->id, thread.joinable());
-		thread.join();
-		logger->info("{}: termination finished", this->id);
-	});
+	std::lock_guard<decltype(lock)> guard(lock);
+	if (reactor_stopped)
+	{
+		return;
+	}
+	heartbeat_registration = reactor->add_timer(heartBeatInterval, heartBeatInterval, [this] { ping(); });
+	socket_registration = reactor->add(socket_provider->GetSocketDescriptor(), EPOLLIN | EPOLLOUT | EPOLLRDHUP,
+		[this](uint32_t events) { on_socket_event(events); });
 }
 
-SocketWire::Client::~Client()
+void SocketWire::Base::on_socket_event(uint32_t events)
 {
-	if (!clientLifetimeDefinition.is_terminated())
+	if (events & EPOLLOUT)
 	{
-		clientLifetimeDefinition.terminate();
+		flush_control();
+	}
+	if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+	{
+		if (!receive_available())
+		{
+			on_disconnected();
+		}
 	}
 }
 
-SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, uint16_t port, const std::string& id)
-	: Base(id, parentLifetime, scheduler), ss(std::make_unique<CPassiveSocket>()), serverLifetimeDefinition(parentLifetime)
+void SocketWire::Base::on_disconnected()
 {
-#ifdef SIGPIPE
-	signal(SIGPIPE, SIG_IGN);
-#endif
-	RD_ASSERT_MSG(ss->Initialize(), fmt::format("{}: failed to initialize socket, reason: {}", this->id, socket->DescribeError()));
-	RD_ASSERT_MSG(ss->Listen("127.0.0.1", port),
-		fmt::format("{}: failed to listen socket on port: {}, reason: {}", this->id, std::to_string(port), ss->DescribeError()));
-
-	this->port = ss->GetServerPort();
-	RD_ASSERT_MSG(this->port != 0, fmt::format("{}: port wasn't chosen", this->id));
-
-	logger->info("{}: listening 127.0.0.1/{}", this->id, this->port);
-	Lifetime lifetime = serverLifetimeDefinition.lifetime;
-
-	thread = std::thread([this, lifetime]() mutable {
-		rd::util::set_thread_name(this->id.empty() ? "SocketWire::Server Thread" : this->id.c_str());
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		reactor->remove(socket_registration);
+		reactor->remove(heartbeat_registration);
+		socket_registration = heartbeat_registration = SocketReactor::INVALID_REGISTRATION;
+	}
 
-		logger->info("{}: started, port: {}.", this->id, this->port);
+	connected.set(false);
 
-		try
+	// shut down first, so that a send blocked on the processing thread fails and pause doesn't wait for it
+	if (!socket_provider->IsSocketValid())
+	{
+		logger->debug("{}: socket was already shut down", this->id);
+	}
+	else if (!socket_provider->Shutdown(CSimpleSocket::Both))
+	{
+		// double close?
+		logger->warn("{}: possibly double close after disconnect", this->id);
+	}
+
+	async_send_buffer.pause("Disconnected");
+
+	std::lock_guard<decltype(lock)> guard(lock);
+	if (!reactor_stopped)
+	{
+		wait_for_connection();
+	}
+}
+
+void SocketWire::Base::stop_reactor()
+{
+	std::array<SocketReactor::registration_t, 3> registrations;
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		reactor_stopped = true;
+		registrations = {connect_registration, socket_registration, heartbeat_registration};
+		connect_registration = socket_registration = heartbeat_registration = SocketReactor::INVALID_REGISTRATION;
+	}
+	// waits for the handlers being run, they may need [lock]
+	for (const auto registration : registrations)
+	{
+		reactor->remove(registration);
+	}
+}
+
+bool SocketWire::Base::receive_available() const
+{
+	const int fd = socket_provider->GetSocketDescriptor();
+	while (true)
+	{
+		if (!parse_received())
+		{
+			return false;
+		}
+
+		// only an incomplete header may be left in [receiver_buffer] after parsing
+		if (lo != receiver_buffer.begin())
+		{
+			hi = std::copy(lo, hi, receiver_buffer.begin());
+			lo = receiver_buffer.begin();
+		}
+
+		Buffer::word_t* destination = &*hi;
+		size_t size = receiver_buffer.end() - hi;
+		bool direct = false;
+		if (receive_len != -1 && lo == hi)
+		{
+			// large package bodies don't need to go through [receiver_buffer]
+			const int32_t target_len = receive_compressed_len == -1 ? receive_len : receive_compressed_len;
+			if (target_len - receive_filled >= DIRECT_RECEIVE_THRESHOLD)
+			{
+				Buffer::word_t* target = receive_compressed_len == -1 ? receive_pkg.data() : compressed_receive_buffer.data();
+				destination = target + receive_filled;
+				size = target_len - receive_filled;
+				direct = true;
+			}
+		}
+
+		const ssize_t read = recv(fd, destination, size, MSG_DONTWAIT);
+		if (read > 0)
+		{
+			logger->trace("{}: receive finished: {} bytes read", this->id, read);
+			if (direct)
+			{
+				receive_filled += static_cast<int32_t>(read);
+			}
+			else
+			{
+				hi += read;
+			}
+			continue;
+		}
+		if (read == 0)
+		{
+			logger->info("{}: socket was shut down for receiving", this->id);
+			flush_control();
+			return false;
+		}
+		if (errno == EINTR)
+		{
+			continue;
+		}
+		if (errno == EAGAIN || errno == EWOULDBLOCK)
+		{
+			// acks of everything received so far go in one write
+			flush_control();
+			return true;
+		}
+		logger->error("{}: error has occurred while receiving, reason: {}", this->id, strerror(errno));
+		return false;
+	}
+}
+
+bool SocketWire::Base::parse_received() const
+{
+	while (true)
+	{
+		if (receive_len == -1)
+		{
+			const auto available = hi - lo;
+			int32_t len = 0;
+			if (available < static_cast<ptrdiff_t>(sizeof(len)))
+			{
+				return true;
+			}
+			std::memcpy(&len, &*lo, sizeof(len));
+			const int32_t header_length =
+				len == COMPRESSED_MESSAGE_LENGTH ? COMPRESSED_PACKAGE_HEADER_LENGTH : PACKAGE_HEADER_LENGTH;
+			if (available < header_length)
+			{
+				return true;
+			}
+			Buffer::word_t const* header = &*lo;
+			lo += header_length;
+
+			if (len == PING_MESSAGE_LENGTH)
+			{
+				int32_t received_timestamp = 0;
+				int32_t received_counterpart_timestamp = 0;
+				std::memcpy(&received_timestamp, header + sizeof(len), sizeof(received_timestamp));
+				std::memcpy(&received_counterpart_timestamp, header + 2 * sizeof(len), sizeof(received_counterpart_timestamp));
+				on_ping(received_timestamp, received_counterpart_timestamp);
+				continue;
+			}
+
+			sequence_number_t seqn = 0;
+			std::memcpy(&seqn, header + sizeof(len), sizeof(seqn));
+			if (len == ACK_MESSAGE_LENGTH)
+			{
+				on_ack(seqn);
+				continue;
+			}
+
+			receive_compressed_len = -1;
+			if (len == COMPRESSED_MESSAGE_LENGTH)
+			{
+				std::memcpy(&receive_compressed_len, header + PACKAGE_HEADER_LENGTH, sizeof(receive_compressed_len));
+				std::memcpy(&len, header + PACKAGE_HEADER_LENGTH + sizeof(len), sizeof(len));
+				if (receive_compressed_len < 0 || len < 0)
+				{
+					logger->error(
+						"{}: invalid compressed package header, compressed={}, raw={}", this->id, receive_compressed_len, len);
+					return false;
+				}
+				compressed_receive_buffer.resize(receive_compressed_len);
+			}
+			else if (len < 0)
+			{
+				logger->error("{}: invalid package length: {}", this->id, len);
+				return false;
+			}
+
+			logger->debug("{}: read len={}, seqn={}, max_received_seqn={}", this->id, len, seqn, max_received_seqn);
+			receive_len = len;
+			receive_seqn = seqn;
+			receive_filled = 0;
+			receive_pkg.rewind();
+			receive_pkg.require_available(len);
+		}
+
+		const bool compressed = receive_compressed_len != -1;
+		Buffer::word_t* target = compressed ? compressed_receive_buffer.data() : receive_pkg.data();
+		const int32_t target_len = compressed ? receive_compressed_len : receive_len;
+		const int32_t copylen = static_cast<int32_t>((std::min)(static_cast<ptrdiff_t>(target_len - receive_filled), hi - lo));
+		std::copy(lo, lo + copylen, target + receive_filled);
+		lo += copylen;
+		receive_filled += copylen;
+		if (receive_filled < target_len)
+		{
+			return true;
+		}
+
+		const int32_t len = receive_len;
+		receive_len = -1;
+		if (compressed && !util::lz4_decompress(compressed_receive_buffer.data(), receive_compressed_len, receive_pkg.data(), len))
+		{
+			logger->error("{}: failed to decompress package, compressed={}, raw={}", this->id, receive_compressed_len, len);
+			return false;
+		}
+
+		if (receive_seqn <= max_received_seqn && receive_seqn != 1)
+		{
+			// resent after reconnect, but has already been received
+			logger->debug("{}: skipped duplicate package, seqn={}", this->id, receive_seqn);
+			request_ack(max_received_seqn);
+			continue;
+		}
+		max_received_seqn = receive_seqn;
+		request_ack(receive_seqn);
+
+		logger->info("{}: was received package, bytes={}, seqn={}", this->id, len, receive_seqn);
+		RD_WIRE_STATS_ONLY(++packages_received; bytes_received += len);
+		if (!dispatch_package(len))
+		{
+			return false;
+		}
+	}
+}
+
+bool SocketWire::Base::dispatch_package(int32_t len) const
+{
+	Buffer::word_t* data = receive_pkg.data();
+	int32_t position = 0;
+	while (position < len)
+	{
+		if (sz == -1)
+		{
+			if (position == 0 && message_header_filled == 0 && len >= MESSAGE_HEADER_LENGTH)
+			{
+				int32_t message_len = 0;
+				std::memcpy(&message_len, data, sizeof(message_len));
+				if ((message_len & ~VARINT_MESSAGE_FLAG) + static_cast<int32_t>(sizeof(message_len)) == len)
+				{
+					// package holding exactly one message is dispatched as is, without copying it to [message]
+					RdId::hash_t hash = 0;
+					std::memcpy(&hash, data + sizeof(message_len), sizeof(hash));
+					auto& array = receive_pkg.get_buffer().get_data();
+					array.resize(len);
+					Buffer whole(std::move(array), MESSAGE_HEADER_LENGTH);
+					whole.set_varint_integrals((message_len & VARINT_MESSAGE_FLAG) != 0);
+					message_broker.dispatch(RdId{hash}, std::move(whole));
+					RD_WIRE_STATS_ONLY(++messages_received);
+					array.clear();
+					logger->debug("{}: message dispatched", this->id);
+					return true;
+				}
+			}
+
+			const int32_t copylen = (std::min)(MESSAGE_HEADER_LENGTH - message_header_filled, len - position);
+			std::copy(data + position, data + position + copylen, message_header.data() + message_header_filled);
+			message_header_filled += copylen;
+			position += copylen;
+			if (message_header_filled < MESSAGE_HEADER_LENGTH)
+			{
+				return true;
+			}
+			message_header_filled = 0;
+			std::memcpy(&sz, message_header.data(), sizeof(sz));
+			std::memcpy(&id_, message_header.data() + sizeof(sz), sizeof(id_));
+			logger->trace("{}: message info: sz={}, id={}", this->id, sz, id_);
+			message.set_varint_integrals(sz >= 0 && (sz & VARINT_MESSAGE_FLAG) != 0);
+			sz = sz >= 0 ? sz & ~VARINT_MESSAGE_FLAG : sz;
+			sz -= 8;	// RdId
+			if (sz < 0)
+			{
+				logger->error("{}: invalid message length: {}", this->id, sz);
+				return false;
+			}
+			message.rewind();
+			message.require_available(sz);
+		}
+
+		const int32_t copylen = (std::min)(sz - static_cast<int32_t>(message.get_position()), len - position);
+		std::copy(data + position, data + position + copylen, message.data() + message.get_position());
+		message.set_position(message.get_position() + copylen);
+		position += copylen;
+		if (static_cast<int32_t>(message.get_position()) == sz)
+		{
+			logger->debug("{}: message received", this->id);
+			message.rewind();
+			message_broker.dispatch(RdId{id_}, std::move(message));
+			RD_WIRE_STATS_ONLY(++messages_received);
+			logger->debug("{}: message dispatched", this->id);
+
+			sz = -1;
+			id_ = -1;
+			message.rewind();
+		}
+	}
+	return true;
+}
+
+void SocketWire::Base::request_ack(sequence_number_t seqn) const
+{
+	std::lock_guard<decltype(control_lock)> guard(control_lock);
+	requested_ack = seqn;
+	control_requested = true;
+}
+
+bool SocketWire::Base::send_control(bool blocking) const
+{
+	const int fd = socket_provider->GetSocketDescriptor();
+	while (true)
+	{
+		while (control_sent < control_sending.get_position())
+		{
+			const ssize_t sent = ::send(fd, control_sending.data() + control_sent, control_sending.get_position() - control_sent,
+				MSG_NOSIGNAL | (blocking ? 0 : MSG_DONTWAIT));
+			if (sent > 0)
+			{
+				control_sent += sent;
+				continue;
+			}
+			if (sent == -1 && errno == EINTR)
+			{
+				continue;
+			}
+			if (sent == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			{
+				// the rest is sent on EPOLLOUT
+				control_requested = true;
+				return false;
+			}
+			// broken connection is going to be noticed by the receiving side
+			logger->debug("{}: failed to send acks and pings, reason: {}", this->id, strerror(errno));
+			control_sending.rewind();
+			control_sent = 0;
+			return false;
+		}
+		control_sending.rewind();
+		control_sent = 0;
+
+		std::lock_guard<decltype(control_lock)> guard(control_lock);
+		if (requested_ack != NO_REQUESTED_ACK)
+		{
+			control_queue.write_integral(ACK_MESSAGE_LENGTH);
+			control_queue.write_integral(requested_ack);
+			requested_ack = NO_REQUESTED_ACK;
+		}
+		control_requested = false;
+		if (control_queue.get_position() == 0)
+		{
+			return true;
+		}
+		std::swap(control_queue, control_sending);
+	}
+}
+
+void SocketWire::Base::flush_control() const
+{
+	// whoever holds [socket_send_lock] is going to call it again after releasing the lock
+	while (control_requested && socket_send_lock.try_lock())
+	{
+		const bool sent = send_control(false);
+		socket_send_lock.unlock();
+		if (!sent)
+		{
+			break;
+		}
+	}
+}
+#endif
+
+#if defined(RD_UNIX_SOCKET)
+static bool make_unix_address(std::string const& path, sockaddr_un& address)
+{
+	address = sockaddr_un{};
+	address.sun_family = AF_UNIX;
+	if (path.empty() || path.size() >= sizeof(address.sun_path))
+	{
+		return false;
+	}
+	std::copy(path.begin(), path.end(), address.sun_path);
+	return true;
+}
+
+/**
+ * \brief clsocket only knows IP sockets, the rest of CSimpleSocket API works for Unix domain sockets as is.
+ */
+class UnixActiveSocket : public CActiveSocket
+{
+public:
+	bool InitializeUnix()
+	{
+		m_nSocketDomain = AF_UNIX;
+		SetSocketHandle(::socket(AF_UNIX, SOCK_STREAM, 0));
+		if (!IsSocketValid())
+		{
+			TranslateSocketError();
+			return false;
+		}
+		return true;
+	}
+
+	bool Open(std::string const& path)
+	{
+		sockaddr_un address;
+		if (!make_unix_address(path, address))
+		{
+			SetSocketError(SocketInvalidAddress);
+			return false;
+		}
+		if (::connect(m_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+		{
+			TranslateSocketError();
+			return false;
+		}
+		return true;
+	}
+};
+
+class UnixPassiveSocket : public CPassiveSocket
+{
+	dev_t device = 0;
+	ino_t inode = 0;
+
+	/**
+	 * \brief True if [path] is a socket file nobody listens to, which a crashed server has left behind.
+	 */
+	static bool is_stale(sockaddr_un const& address)
+	{
+		struct stat status;
+		if (::lstat(address.sun_path, &status) != 0 || !S_ISSOCK(status.st_mode))
+		{
+			return false;
+		}
+		const int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		if (probe == -1)
+		{
+			return false;
+		}
+		const bool refused =
+			::connect(probe, reinterpret_cast<sockaddr const*>(&address), sizeof(address)) != 0 && errno == ECONNREFUSED;
+		::close(probe);
+		return refused;
+	}
+
+public:
+	bool Listen(std::string const& path)
+	{
+		sockaddr_un address;
+		if (!make_unix_address(path, address))
+		{
+			SetSocketError(SocketInvalidAddress);
+			return false;
+		}
+		m_nSocketDomain = AF_UNIX;
+		SetSocketHandle(::socket(AF_UNIX, SOCK_STREAM, 0));
+		if (!IsSocketValid())
+		{
+			TranslateSocketError();
+			return false;
+		}
+
+		struct stat status;
+		if (::lstat(path.c_str(), &status) == 0)
+		{
+			// only a socket file left by a crashed server is replaced, anything else at the path is kept
+			if (!is_stale(address))
+			{
+				SetSocketError(SocketAddressInUse);
+				return false;
+			}
+			::unlink(path.c_str());
+		}
+
+		if (::bind(m_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+		{
+			TranslateSocketError();
+			if (errno == EADDRINUSE)
+			{
+				SetSocketError(SocketAddressInUse);
+			}
+			return false;
+		}
+		if (::lstat(path.c_str(), &status) == 0)
+		{
+			device = status.st_dev;
+			inode = status.st_ino;
+		}
+		if (::listen(m_socket, SOMAXCONN) != 0)
+		{
+			TranslateSocketError();
+			return false;
+		}
+		return true;
+	}
+
+	/**
+	 * \brief Removes the socket file created by [Listen] unless it has been replaced since.
+	 */
+	void Unlink(std::string const& path) const
+	{
+		struct stat status;
+		if (inode != 0 && ::lstat(path.c_str(), &status) == 0 && status.st_dev == device && status.st_ino == inode)
+		{
+			::unlink(path.c_str());
+		}
+	}
+};
+#endif
+
+SocketWire::Client::Client(Lifetime parentLifetime, IScheduler* scheduler, uint16_t port, const std::string& id)
+	: Base(id, parentLifetime, scheduler), port(port), clientLifetimeDefinition(parentLifetime)
+{
+	start();
+}
+
+#if defined(RD_UNIX_SOCKET)
+SocketWire::Client::Client(
+	Lifetime parentLifetime, IScheduler* scheduler, std::string unix_socket_path, const std::string& id)
+	: Base(id, parentLifetime, scheduler), unix_socket_path(std::move(unix_socket_path)), clientLifetimeDefinition(parentLifetime)
+{
+	start();
+}
+#endif
+
+std::shared_ptr<CActiveSocket> SocketWire::Client::create_socket() const
+{
+#if defined(RD_UNIX_SOCKET)
+	if (!unix_socket_path.empty())
+	{
+		auto new_socket = std::make_shared<UnixActiveSocket>();
+		RD_ASSERT_THROW_MSG(new_socket->InitializeUnix(),
+			fmt::format("{}: failed to init ActiveSocket, reason: {}", this->id, new_socket->DescribeError()));
+		return new_socket;
+	}
+#endif
+	auto new_socket = std::make_shared<CActiveSocket>();
+	RD_ASSERT_THROW_MSG(new_socket->Initialize(),
+		fmt::format("{}: failed to init ActiveSocket, reason: {}", this->id, new_socket->DescribeError()));
+	RD_ASSERT_THROW_MSG(new_socket->DisableNagleAlgoritm(),
+		fmt::format("{}: failed to DisableNagleAlgoritm, reason: {}", this->id, new_socket->DescribeError()));
+	return new_socket;
+}
+
+std::shared_ptr<CActiveSocket> SocketWire::Client::open_socket() const
+{
+	auto new_socket = create_socket();
+#if defined(RD_UNIX_SOCKET)
+	if (!unix_socket_path.empty())
+	{
+		logger->info("{}: connecting {}", this->id, unix_socket_path);
+		RD_ASSERT_THROW_MSG(static_cast<UnixActiveSocket&>(*new_socket).Open(unix_socket_path),
+			fmt::format("{}: failed to open ActiveSocket, reason: {}", this->id, new_socket->DescribeError()));
+		return new_socket;
+	}
+#endif
+
+	// On windows connect will try to send SYN 3 times with interval of 500ms (total time is 1second)
+	// Connect timeout doesn't work if it's more than 1 second. But we don't need it because we can close socket any
+	// moment.
+
+	// https://stackoverflow.com/questions/22417228/prevent-tcp-socket-connection-retries
+	// HKLM\SYSTEM\CurrentControlSet\Services\Tcpip\Parameters\TcpMaxConnectRetransmissions
+	logger->info("{}: connecting 127.0.0.1: {}", this->id, this->port);
+	RD_ASSERT_THROW_MSG(new_socket->Open("127.0.0.1", this->port),
+		fmt::format("{}: failed to open ActiveSocket, reason: {}", this->id, new_socket->DescribeError()));
+	return new_socket;
+}
+
+void SocketWire::Client::start()
+{
+	Lifetime lifetime = clientLifetimeDefinition.lifetime;
+#if defined(RD_SOCKET_REACTOR)
+	logger->info("{}: started, port: {}.", this->id, this->port);
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		wait_for_connection();
+	}
+#else
+	thread = std::thread([this, lifetime]() mutable {
+		rd::util::set_thread_name(this->id.empty() ? "SocketWire::Client Thread" : this->id.c_str());
+
+		try
+		{
+			logger->info("{}: started, port: {}.", this->id, this->port);
+
+			while (!lifetime->is_terminated())
+			{
+				try
+				{
+					socket = open_socket();
+					{
+						std::lock_guard<decltype(lock)> guard(lock);
+						if (lifetime->is_terminated())
+						{
+							if (!socket->Close())
+							{
+								logger->error("{} failed to close socket, reason: {}", this->id, socket->DescribeError());
+							}
+							return;
+						}
+					}
+
+					set_socket_provider(socket);
+				}
+				catch (std::exception const& e)
+				{
+					logger->debug("{}: connection error for port {} ({}).", this->id, this->port, e.what());
+
+					std::lock_guard<decltype(lock)> guard(lock);
+					bool should_reconnect = false;
+					if (!lifetime->is_terminated())
+					{
+						cv.wait_for(lock, timeout);
+						should_reconnect = !lifetime->is_terminated();
+					}
+					if (should_reconnect)
+					{
+						continue;
+					}
+					break;
+				}
+			}
+		}
+		catch (std::exception const& e)
+		{
+			logger->info("{}: closed with exception: {}", this->id, e.what());
+		}
+		logger->info("{}: terminated, port: {}.", this->id, this->port);
+	});
+#endif
+
+	lifetime->add_action([this]() {
+		logger->info("{}: starts terminating lifetime", this->id);
+
+		const bool send_buffer_stopped = async_send_buffer.stop(timeout);
+		logger->debug("{}: send buffer stopped, success: {}", this->id, send_buffer_stopped);
+#if defined(RD_SOCKET_REACTOR)
+		stop_reactor();
+#endif
+
+		{
+			std::lock_guard<decltype(lock)> guard(lock);
+			logger->debug("{}: closing socket", this->id);
+
+			if (socket != nullptr)
+			{
+				if (!socket->Close())
+				{
+					logger->error("{}: failed to close socket", this->id);
+				}
+			}
+#if defined(RD_SOCKET_REACTOR)
+			if (connecting != nullptr)
+			{
+				connecting->Close();
+				connecting.reset();
+			}
+#endif
+		}
+		cv.notify_all();
+
+#if !defined(RD_SOCKET_REACTOR)
+		logger->debug("{}: waiting for receiver thread", this->id);
+		logger->debug("{}: is thread joinable? {}", this->id, thread.joinable());
+		thread.join();
+#endif
+		logger->info("{}: termination finished", this->id);
+	});
+}
+
+SocketWire::Client::~Client()
+{
+	if (!clientLifetimeDefinition.is_terminated())
+	{
+		clientLifetimeDefinition.terminate();
+	}
+}
+
+#if defined(RD_SOCKET_REACTOR)
+void SocketWire::Client::wait_for_connection()
+{
+	connect_registration =
+		reactor->add_timer(std::chrono::milliseconds(0), std::chrono::milliseconds(0), [this] { try_connect(); });
+}
+
+int SocketWire::Client::begin_connect(CActiveSocket& new_socket) const
+{
+	int result;
+#if defined(RD_UNIX_SOCKET)
+	if (!unix_socket_path.empty())
+	{
+		logger->info("{}: connecting {}", this->id, unix_socket_path);
+		sockaddr_un address;
+		if (!make_unix_address(unix_socket_path, address))
+		{
+			return EINVAL;
+		}
+		result = ::connect(new_socket.GetSocketDescriptor(), reinterpret_cast<sockaddr*>(&address), sizeof(address));
+	}
+	else
+#endif
+	{
+		logger->info("{}: connecting 127.0.0.1: {}", this->id, this->port);
+		sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_port = htons(this->port);
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		result = ::connect(new_socket.GetSocketDescriptor(), reinterpret_cast<sockaddr*>(&address), sizeof(address));
+	}
+	if (result == 0)
+	{
+		return 0;
+	}
+	// interrupted connect goes on in background like a non-blocking one
+	return errno == EINTR ? EINPROGRESS : errno;
+}
+
+void SocketWire::Client::try_connect()
+{
+	try
+	{
+		auto new_socket = create_socket();
+		RD_ASSERT_THROW_MSG(new_socket->SetNonblocking(),
+			fmt::format("{}: failed to make socket non-blocking, reason: {}", this->id, new_socket->DescribeError()));
+
+		const int error = begin_connect(*new_socket);
+		if (error == 0)
+		{
+			connection_completed(std::move(new_socket));
+			return;
+		}
+		RD_ASSERT_THROW_MSG(error == EINPROGRESS, fmt::format("{}: failed to connect, reason: {}", this->id, strerror(error)));
+
+		std::lock_guard<decltype(lock)> guard(lock);
+		connect_registration = SocketReactor::INVALID_REGISTRATION;
+		if (reactor_stopped)
+		{
+			new_socket->Close();
+			return;
+		}
+		// the outcome of the connection is reported as writability of the socket
+		connecting = std::move(new_socket);
+		connect_registration =
+			reactor->add(connecting->GetSocketDescriptor(), EPOLLOUT, [this](uint32_t) { on_connect_event(); });
+	}
+	catch (std::exception const& e)
+	{
+		logger->debug("{}: connection error for port {} ({}).", this->id, this->port, e.what());
+		retry_connect();
+	}
+}
+
+void SocketWire::Client::on_connect_event()
+{
+	std::shared_ptr<CActiveSocket> new_socket;
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		reactor->remove(connect_registration);
+		connect_registration = SocketReactor::INVALID_REGISTRATION;
+		new_socket = std::move(connecting);
+	}
+	if (new_socket == nullptr)
+	{
+		return;
+	}
+
+	int error = 0;
+	socklen_t length = sizeof(error);
+	if (getsockopt(new_socket->GetSocketDescriptor(), SOL_SOCKET, SO_ERROR, &error, &length) != 0)
+	{
+		error = errno;
+	}
+	if (error != 0)
+	{
+		logger->debug("{}: connection error for port {} ({}).", this->id, this->port, strerror(error));
+		new_socket->Close();
+		retry_connect();
+		return;
+	}
+	connection_completed(std::move(new_socket));
+}
+
+void SocketWire::Client::connection_completed(std::shared_ptr<CActiveSocket> new_socket)
+{
+	// packages are sent by blocking writes of the processing thread, the reactor never waits on the socket
+	if (!new_socket->SetBlocking())
+	{
+		logger->warn("{}: failed to make socket blocking, reason: {}", this->id, new_socket->DescribeError());
+	}
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		connect_registration = SocketReactor::INVALID_REGISTRATION;
+		if (reactor_stopped)
+		{
+			if (!new_socket->Close())
+			{
+				logger->error("{} failed to close socket, reason: {}", this->id, new_socket->DescribeError());
+			}
+			return;
+		}
+		socket = new_socket;
+	}
+
+	start_receiving(std::move(new_socket));
+}
+
+void SocketWire::Client::retry_connect()
+{
+	std::lock_guard<decltype(lock)> guard(lock);
+	connect_registration = SocketReactor::INVALID_REGISTRATION;
+	if (!reactor_stopped)
+	{
+		connect_registration = reactor->add_timer(timeout, std::chrono::milliseconds(0), [this] { try_connect(); });
+	}
+}
+#endif
+
+SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, uint16_t port, const std::string& id)
+	: Base(id, parentLifetime, scheduler), ss(std::make_unique<CPassiveSocket>()), serverLifetimeDefinition(parentLifetime)
+{
+#ifdef SIGPIPE
+	signal(SIGPIPE, SIG_IGN);
+#endif
+	RD_ASSERT_MSG(ss->Initialize(), fmt::format("{}: failed to initialize socket, reason: {}", this->id, socket->DescribeError()));
+	RD_ASSERT_MSG(ss->Listen("127.0.0.1", port),
+		fmt::format("{}: failed to listen socket on port: {}, reason: {}", this->id, std::to_string(port), ss->DescribeError()));
+
+	this->port = ss->GetServerPort();
+	RD_ASSERT_MSG(this->port != 0, fmt::format("{}: port wasn't chosen", this->id));
+
+	logger->info("{}: listening 127.0.0.1/{}", this->id, this->port);
+	start();
+}
+
+#if defined(RD_UNIX_SOCKET)
+SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, std::string unix_socket_path, const std::string& id)
+	: Base(id, parentLifetime, scheduler)
+	, unix_socket_path(std::move(unix_socket_path))
+	, ss(std::make_unique<UnixPassiveSocket>())
+	, serverLifetimeDefinition(parentLifetime)
+{
+#ifdef SIGPIPE
+	signal(SIGPIPE, SIG_IGN);
+#endif
+	RD_ASSERT_MSG(static_cast<UnixPassiveSocket&>(*ss).Listen(this->unix_socket_path),
+		fmt::format("{}: failed to listen socket {}, reason: {}", this->id, this->unix_socket_path, ss->DescribeError()));
+
+	logger->info("{}: listening {}", this->id, this->unix_socket_path);
+	start();
+}
+#endif
+
+void SocketWire::Server::start()
+{
+	Lifetime lifetime = serverLifetimeDefinition.lifetime;
+
+#if defined(RD_SOCKET_REACTOR)
+	RD_ASSERT_MSG(ss->SetNonblocking(), fmt::format("{}: failed to make server socket non-blocking, reason: {}", this->id, ss->DescribeError()));
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		wait_for_connection();
+	}
+#else
+	thread = std::thread([this, lifetime]() mutable {
+		rd::util::set_thread_name(this->id.empty() ? "SocketWire::Server Thread" : this->id.c_str());
+
+		logger->info("{}: started, port: {}.", this->id, this->port);
+
+		try
 		{
 			while (!lifetime->is_terminated())
 			{
@@ -589,9 +1710,12 @@ SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, uint1
 					RD_ASSERT_THROW_MSG(
 						accepted != nullptr, fmt::format("{}: accepting failed, reason: {}", this->id, ss->DescribeError()));
 					socket.reset(accepted);
-					logger->info("{}: accepted passive socket {}/{}", this->id, socket->GetClientAddr(), socket->GetClientPort());
-					RD_ASSERT_THROW_MSG(socket->DisableNagleAlgoritm(),
-						fmt::format("{}: tcpNoDelay failed, reason: {}", this->id, socket->DescribeError()));
+					if (unix_socket_path.empty())
+					{
+						logger->info("{}: accepted passive socket {}/{}", this->id, socket->GetClientAddr(), socket->GetClientPort());
+						RD_ASSERT_THROW_MSG(socket->DisableNagleAlgoritm(),
+							fmt::format("{}: tcpNoDelay failed, reason: {}", this->id, socket->DescribeError()));
+					}
 
 					{
 						std::lock_guard<decltype(lock)> guard(lock);
@@ -622,18 +1746,28 @@ SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, uint1
 
 		logger->info("{}: terminated, port: {}.", this->id, this->port);
 	});
+#endif
 
 	lifetime->add_action([this] {
 		logger->info("{}: start terminating lifetime", this->id);
 
 		const bool send_buffer_stopped = async_send_buffer.stop(timeout);
 		logger->debug("{}: send buffer stopped, success: {}", this->id, send_buffer_stopped);
+#if defined(RD_SOCKET_REACTOR)
+		stop_reactor();
+#endif
 
 		logger->debug("{}: closing server socket", this->id);
 		if (!ss->Close())
 		{
 			logger->error("{}: failed to close server socket", this->id);
 		}
+#if defined(RD_UNIX_SOCKET)
+		if (!unix_socket_path.empty())
+		{
+			static_cast<UnixPassiveSocket&>(*ss).Unlink(unix_socket_path);
+		}
+#endif
 
 		{
 			std::lock_guard<decltype(lock)> guard(lock);
@@ -647,9 +1781,11 @@ SocketWire::Server::Server(Lifetime parentLifetime, IScheduler* scheduler, uint1
 			}
 		}
 
+#if !defined(RD_SOCKET_REACTOR)
 		logger->debug("{}: waiting for receiver thread", this->id);
 		logger->debug("{}: is thread joinable? {}", this->id, thread.joinable());
 		thread.join();
+#endif
 		logger->info("{}: termination finished", this->id);
 	});
 }
@@ -662,4 +1798,55 @@ SocketWire::Server::~Server()
 	}
 }
 
+#if defined(RD_SOCKET_REACTOR)
+void SocketWire::Server::wait_for_connection()
+{
+	logger->info("{}: accepting started", this->id);
+	// connections pending in the backlog are reported at once
+	connect_registration = reactor->add(ss->GetSocketDescriptor(), EPOLLIN, [this](uint32_t) { accept_available(); });
+}
+
+void SocketWire::Server::accept_available()
+{
+	CActiveSocket* accepted = ss->Accept();
+	if (accepted == nullptr)
+	{
+		if (ss->GetSocketError() != CSimpleSocket::SocketEwouldblock)
+		{
+			logger->error("{}: accepting failed, reason: {}", this->id, ss->DescribeError());
+		}
+		return;
+	}
+
+	std::shared_ptr<CActiveSocket> new_socket(accepted);
+	{
+		std::lock_guard<decltype(lock)> guard(lock);
+		// one connection at a time, the next one is accepted after this one is closed
+		reactor->remove(connect_registration);
+		connect_registration = SocketReactor::INVALID_REGISTRATION;
+		if (reactor_stopped)
+		{
+			logger->debug("{}: closing passive socket", this->id);
+			if (!new_socket->Close())
+			{
+				logger->error("{}: failed to close socket", this->id);
+			}
+			return;
+		}
+		socket = new_socket;
+	}
+	if (unix_socket_path.empty())
+	{
+		logger->info("{}: accepted passive socket {}/{}", this->id, new_socket->GetClientAddr(), new_socket->GetClientPort());
+		if (!new_socket->DisableNagleAlgoritm())
+		{
+			logger->warn("{}: tcpNoDelay failed, reason: {}", this->id, new_socket->DescribeError());
+		}
+	}
+
+	logger->debug("{}: setting socket provider", this->id);
+	start_receiving(std::move(new_socket));
+}
+#endif
+
 }	 // namespace rd
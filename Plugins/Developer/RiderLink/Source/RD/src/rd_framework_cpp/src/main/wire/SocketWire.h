@@ -10,10 +10,14 @@
 #include "base/WireBase.h"
 #include "ByteBufferAsyncProcessor.h"
 #include "PkgInputStream.h"
+#include "SocketReactor.h"
+#include "WireStats.h"
 
 #include <string>
 #include <array>
+#include <atomic>
 #include <condition_variable>
+#include <limits>
 
 #include <rd_framework_export.h>
 
@@ -21,6 +25,10 @@ class CSimpleSocket;
 class CActiveSocket;
 class CPassiveSocket;
 
+#if !defined(_WIN32)
+#define RD_UNIX_SOCKET 1
+#endif
+
 namespace rd
 {
 class RD_FRAMEWORK_API SocketWire
@@ -46,10 +54,17 @@ public:
 		std::shared_ptr<CActiveSocket> socket;
 
 		mutable std::condition_variable socket_send_var;
+		static constexpr size_t INITIAL_SEND_BUFFER_SIZE = 256;
+		mutable ByteArrayPool send_buffer_pool;
 		mutable ByteBufferAsyncProcessor async_send_buffer{id + "-AsyncSendProcessor",
-			[this](Buffer::ByteArray const& it, sequence_number_t seqn) -> bool { return this->send0(it, seqn); }};
+			[this](ByteBufferAsyncProcessor::batch_t const& it, sequence_number_t seqn) -> bool { return this->send0(it, seqn); },
+			&send_buffer_pool};
 
 		static constexpr size_t RECEIVE_BUFFER_SIZE = 1u << 16;
+		/**
+		 * \brief Reads of at least this size go straight from the socket to the destination, bypassing [receiver_buffer].
+		 */
+		static constexpr int32_t DIRECT_RECEIVE_THRESHOLD = 4096;
 		mutable std::array<Buffer::word_t, RECEIVE_BUFFER_SIZE> receiver_buffer{};
 		mutable decltype(receiver_buffer)::iterator lo = receiver_buffer.begin(), hi = receiver_buffer.begin();
 
@@ -58,6 +73,41 @@ public:
 		static constexpr int32_t PACKAGE_HEADER_LENGTH = sizeof(ACK_MESSAGE_LENGTH) + sizeof(sequence_number_t);
 		mutable Buffer ack_buffer{PACKAGE_HEADER_LENGTH};
 
+		/**
+		 * \brief Package header is followed by compressed length and raw length, then by LZ4 block.
+		 */
+		static constexpr int32_t COMPRESSED_MESSAGE_LENGTH = -3;
+		static constexpr int32_t COMPRESSED_PACKAGE_HEADER_LENGTH = PACKAGE_HEADER_LENGTH + 2 * sizeof(int32_t);
+		/**
+		 * \brief Sent in ACK instead of sequence number to announce that compressed packages can be received. Peers which
+		 * don't support compression ignore it as an outdated acknowledge.
+		 */
+		static constexpr sequence_number_t COMPRESSION_SUPPORTED_SEQN = -0x4C5A34;
+
+		mutable std::atomic<int32_t> compression_threshold{0};
+		mutable std::atomic<bool> counterpart_supports_compression{false};
+		mutable bool compression_announced = false;
+		mutable std::vector<Buffer::ByteArray> compressed_packages;
+		mutable Buffer::ByteArray compressed_receive_buffer;
+
+		/**
+		 * \brief Set in the length of a message written with varint integrals, see [Buffer::set_varint_integrals].
+		 */
+		static constexpr int32_t VARINT_MESSAGE_FLAG = 1 << 30;
+		/**
+		 * \brief Sent in ACK instead of sequence number to announce that messages with varint integrals can be received.
+		 */
+		static constexpr sequence_number_t VARINT_SUPPORTED_SEQN = -0x564152;
+
+		mutable std::atomic<bool> varint_enabled{false};
+		// reset on reconnection, the flag in the length of each message tells how it was written, so resent
+		// packages are read correctly by any counterpart supporting varints
+		mutable std::atomic<bool> counterpart_supports_varint{false};
+		mutable bool varint_announced = false;
+
+		static void write_message(
+			Buffer& buffer, RdId const& rd_id, bool varint_integrals, std::function<void(Buffer& buffer)> const& writer);
+
 		/**
 		 * \brief Timestamp of this wire which increases at intervals of [heartBeatInterval].
 		 */
@@ -78,6 +128,8 @@ public:
 		mutable sequence_number_t max_received_seqn = 0;
 		mutable Buffer send_package_header{PACKAGE_HEADER_LENGTH};
 
+		static constexpr size_t SEND_VECTOR_PACKAGES = 64;
+
 		static constexpr int32_t CHUNK_SIZE = 16370;
 		mutable int32_t sz = -1;
 		mutable RdId::hash_t id_ = -1;
@@ -85,6 +137,12 @@ public:
 
 		mutable Buffer message{CHUNK_SIZE};
 
+		mutable std::atomic<uint64_t> packages_sent{0};
+		mutable std::atomic<uint64_t> bytes_sent{0};
+		mutable std::atomic<uint64_t> packages_received{0};
+		mutable std::atomic<uint64_t> bytes_received{0};
+		mutable std::atomic<uint64_t> messages_received{0};
+
 		bool read_from_socket(Buffer::word_t* res, int32_t msglen) const;
 
 		template <typename T>
@@ -98,10 +156,88 @@ public:
 			return read_from_socket(reinterpret_cast<Buffer::word_t*>(data), static_cast<int32_t>(len));
 		}
 
+		int32_t read_compressed_package() const;
+
 		void set_socket_provider(std::shared_ptr<CActiveSocket> new_socket);
 
 		CSimpleSocket* get_socket_provider() const;
 
+		void on_ping(int32_t received_timestamp, int32_t received_counterpart_timestamp) const;
+
+		void on_ack(sequence_number_t seqn) const;
+
+#if defined(RD_SOCKET_REACTOR)
+		/**
+		 * \brief Accepting, receiving and heartbeat of all wires are driven by one shared reactor thread instead of
+		 * blocking threads of their own.
+		 */
+		std::shared_ptr<SocketReactor> reactor = SocketReactor::get();
+		bool reactor_stopped = false;
+		SocketReactor::registration_t connect_registration = SocketReactor::INVALID_REGISTRATION;
+		SocketReactor::registration_t socket_registration = SocketReactor::INVALID_REGISTRATION;
+		SocketReactor::registration_t heartbeat_registration = SocketReactor::INVALID_REGISTRATION;
+
+		/**
+		 * \brief Acks and pings wait here until the socket can take them without blocking the reactor. Acks are
+		 * coalesced, the counterpart treats them as cumulative.
+		 */
+		static constexpr sequence_number_t NO_REQUESTED_ACK = std::numeric_limits<sequence_number_t>::min();
+		mutable std::mutex control_lock;
+		mutable Buffer control_queue{PACKAGE_HEADER_LENGTH};
+		mutable sequence_number_t requested_ack = NO_REQUESTED_ACK;
+		mutable std::atomic<bool> control_requested{false};
+		mutable Buffer control_sending{PACKAGE_HEADER_LENGTH};
+		mutable size_t control_sent = 0;
+
+		/**
+		 * \brief State of the package being received, its length is -1 while the header hasn't been received yet.
+		 */
+		mutable int32_t receive_len = -1;
+		mutable int32_t receive_compressed_len = -1;
+		mutable int32_t receive_filled = 0;
+		mutable sequence_number_t receive_seqn = 0;
+
+		static constexpr int32_t MESSAGE_HEADER_LENGTH = sizeof(int32_t) + sizeof(RdId::hash_t);
+		mutable std::array<Buffer::word_t, MESSAGE_HEADER_LENGTH> message_header{};
+		mutable int32_t message_header_filled = 0;
+
+		/**
+		 * \brief Reads everything available from the socket without blocking.
+		 * \return false if the connection is closed.
+		 */
+		bool receive_available() const;
+
+		bool parse_received() const;
+
+		/**
+		 * \brief Splits the received package to messages, assembling the ones spanning several packages.
+		 */
+		bool dispatch_package(int32_t len) const;
+
+		void request_ack(sequence_number_t seqn) const;
+
+		/**
+		 * \brief Sends queued acks and pings, must be called under [socket_send_lock].
+		 * \return false if some of them are left for later because the socket would block.
+		 */
+		bool send_control(bool blocking) const;
+
+		void flush_control() const;
+
+		void start_receiving(std::shared_ptr<CActiveSocket> new_socket);
+
+		void on_socket_event(uint32_t events);
+
+		void on_disconnected();
+
+		/**
+		 * \brief Starts accepting or establishing the next connection, called under [lock].
+		 */
+		virtual void wait_for_connection() = 0;
+
+		void stop_reactor();
+#endif
+
 	public:
 		static constexpr int32_t MaximumHeartbeatDelay = 3;
 		std::chrono::milliseconds heartBeatInterval = std::chrono::milliseconds(500);
@@ -122,10 +258,20 @@ public:
 
 		void receiverProc() const;
 
-		bool send0(Buffer::ByteArray const& msg, sequence_number_t seqn) const;
+		/**
+		 * \brief Sends consecutive packages with their headers in a single vectored write.
+		 * \param packages to be sent.
+		 * \param first_seqn sequence number of the first package.
+		 */
+		bool send0(ByteBufferAsyncProcessor::batch_t const& packages, sequence_number_t first_seqn) const;
 
 		void send(RdId const& rd_id, std::function<void(Buffer& buffer)> writer) const override;
 
+		/**
+		 * \brief Writes all [messages] into one buffer, so that they are sent as a single package.
+		 */
+		void send_batch(std::vector<std::pair<RdId, std::function<void(Buffer& buffer)>>> const& messages) const override;
+
 		static bool connection_established(int32_t timestamp, int32_t acknowledged_timestamp);
 
 		std::future<void> start_heartbeat(Lifetime lifetime);
@@ -135,6 +281,37 @@ public:
 		bool send_ack(sequence_number_t seqn) const;
 
 		bool try_shutdown_connection() const;
+
+		/**
+		 * \brief Limits the amount of sent but not acknowledged data, see [ByteBufferAsyncProcessor::set_max_unacknowledged_bytes].
+		 */
+		void set_max_unacknowledged_bytes(size_t value) const;
+
+		/**
+		 * \brief Hit/miss counters of the pool outgoing packages are allocated from.
+		 */
+		ByteArrayPool::Stats get_send_buffer_pool_stats() const;
+
+		/**
+		 * \brief Traffic counters, acknowledge latency and allocations of this wire since it was created. Only pool
+		 * counters are collected unless RD_WIRE_STATS is defined, see [WireStats].
+		 */
+		WireStats get_stats() const;
+
+		/**
+		 * \brief Enables LZ4 compression of packages not smaller than [threshold] bytes, zero disables it. Compressed
+		 * packages are sent only after counterpart has announced that it supports them during PING exchange.
+		 */
+		void set_compression_threshold(int32_t threshold) const;
+
+		/**
+		 * \brief Enables writing integrals of messages as varints, which makes small numbers such as lengths, versions
+		 * and indices take a single byte. Like compression it's used only after counterpart has announced that it
+		 * supports it, messages written before keep fixed width integrals.
+		 */
+		void set_varint_integrals(bool enabled) const;
+
+		bool varint_integrals() const override;
 		
 	private:		
 		LifetimeDefinition lifetimeDef;
@@ -145,16 +322,62 @@ public:
 	public:
 		uint16_t port = 0;
 
+		/**
+		 * \brief Path of the Unix domain socket connected to instead of [port] if not empty.
+		 */
+		std::string unix_socket_path;
+
 		// region ctor/dtor
 
 		Client(Lifetime parentLifetime, IScheduler* scheduler, uint16_t port = 0, const std::string& id = "ClientSocket");
 
+#if defined(RD_UNIX_SOCKET)
+		/**
+		 * \brief Connects to the Unix domain socket [unix_socket_path] of a local [Server], bypassing TCP/IP stack.
+		 */
+		Client(Lifetime parentLifetime, IScheduler* scheduler, std::string unix_socket_path,
+			const std::string& id = "ClientSocket");
+#endif
+
 		virtual ~Client() override;
 		// endregion
 
 		std::condition_variable_any cv;
 	private:		
 		LifetimeDefinition clientLifetimeDefinition;
+
+		void start();
+
+		/**
+		 * \brief Socket of the endpoint this client connects to, not connected yet.
+		 */
+		std::shared_ptr<CActiveSocket> create_socket() const;
+
+		std::shared_ptr<CActiveSocket> open_socket() const;
+
+#if defined(RD_SOCKET_REACTOR)
+		/**
+		 * \brief Socket whose non-blocking connect is in progress, it's completed on EPOLLOUT.
+		 */
+		std::shared_ptr<CActiveSocket> connecting;
+
+		/**
+		 * \brief Starts connecting non-blocking [new_socket].
+		 * \return 0 if it's connected at once, EINPROGRESS if the outcome is reported on EPOLLOUT, the error otherwise.
+		 */
+		int begin_connect(CActiveSocket& new_socket) const;
+
+		void try_connect();
+
+		void on_connect_event();
+
+		void connection_completed(std::shared_ptr<CActiveSocket> new_socket);
+
+		void retry_connect();
+
+	protected:
+		void wait_for_connection() override;
+#endif
 	};
 
 	class RD_FRAMEWORK_API Server : public Base
@@ -162,16 +385,38 @@ public:
 	public:
 		uint16_t port = 0;
 
+		/**
+		 * \brief Path of the Unix domain socket listened instead of [port] if not empty.
+		 */
+		std::string unix_socket_path;
+
 		std::unique_ptr<CPassiveSocket> ss;
 
 		// region ctor/dtor
 
 		Server(Lifetime lifetime, IScheduler* scheduler, uint16_t port = 0, const std::string& id = "ServerSocket");
 
+#if defined(RD_UNIX_SOCKET)
+		/**
+		 * \brief Listens the Unix domain socket [unix_socket_path]. A socket file nobody listens to is replaced, anything
+		 * else at the path fails with "address in use".
+		 */
+		Server(Lifetime lifetime, IScheduler* scheduler, std::string unix_socket_path, const std::string& id = "ServerSocket");
+#endif
+
 		virtual ~Server() override;
 		// endregion
 	private:
 		LifetimeDefinition serverLifetimeDefinition;
+
+		void start();
+
+#if defined(RD_SOCKET_REACTOR)
+		void accept_available();
+
+	protected:
+		void wait_for_connection() override;
+#endif
 	};
 };
 }	 // namespace rd
@@ -0,0 +1,60 @@
+#include "WireStats.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace rd
+{
+constexpr size_t LatencyHistogram::BUCKETS;
+
+void LatencyHistogram::record(std::chrono::steady_clock::duration latency)
+{
+	auto micros = static_cast<uint64_t>((std::max)(
+		std::chrono::duration_cast<std::chrono::microseconds>(latency).count(), static_cast<std::chrono::microseconds::rep>(0)));
+	size_t bucket = 0;
+	while (micros > 1 && bucket + 1 < BUCKETS)
+	{
+		micros >>= 1;
+		++bucket;
+	}
+	++buckets[bucket];
+	++count;
+}
+
+uint64_t LatencyHistogram::get_count() const
+{
+	return count;
+}
+
+std::chrono::microseconds LatencyHistogram::percentile(double quantile) const
+{
+	if (count == 0)
+	{
+		return std::chrono::microseconds(0);
+	}
+	const auto rank = static_cast<uint64_t>(quantile * static_cast<double>(count));
+	uint64_t seen = 0;
+	for (size_t i = 0; i < BUCKETS; ++i)
+	{
+		seen += buckets[i];
+		if (seen > rank || seen == count)
+		{
+			return std::chrono::microseconds(uint64_t(1) << (i + 1));
+		}
+	}
+	return std::chrono::microseconds(uint64_t(1) << BUCKETS);
+}
+
+std::string to_string(WireStats const& stats)
+{
+	std::ostringstream out;
+	out << "{\"packages_sent\":" << stats.packages_sent << ",\"bytes_sent\":" << stats.bytes_sent
+		<< ",\"packages_received\":" << stats.packages_received << ",\"bytes_received\":" << stats.bytes_received
+		<< ",\"messages_received\":" << stats.messages_received << ",\"ack_latency_us\":{\"count\":" << stats.ack_latency.get_count()
+		<< ",\"p50\":" << stats.ack_latency.percentile(0.5).count() << ",\"p99\":" << stats.ack_latency.percentile(0.99).count()
+		<< ",\"p999\":" << stats.ack_latency.percentile(0.999).count() << "},\"send_buffer_pool\":{\"hits\":"
+		<< stats.send_buffer_pool.hits << ",\"misses\":" << stats.send_buffer_pool.misses
+		<< ",\"recycled\":" << stats.send_buffer_pool.recycled << ",\"discarded\":" << stats.send_buffer_pool.discarded << "}}";
+	return out.str();
+}
+}	 // namespace rd
@@ -0,0 +1,89 @@
+#ifndef RD_CPP_WIRESTATS_H
+#define RD_CPP_WIRESTATS_H
+
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+#include "ByteArrayPool.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include <rd_framework_export.h>
+
+namespace rd
+{
+/**
+ * \brief Histogram of latencies with power of two buckets: bucket i counts latencies in [2^i, 2^(i+1)) microseconds.
+ */
+class RD_FRAMEWORK_API LatencyHistogram
+{
+public:
+	static constexpr size_t BUCKETS = 32;
+
+private:
+	std::array<uint64_t, BUCKETS> buckets{};
+	uint64_t count = 0;
+
+public:
+	void record(std::chrono::steady_clock::duration latency);
+
+	uint64_t get_count() const;
+
+	/**
+	 * \brief Upper bound of the bucket holding the given quantile (0.5, 0.99...) of recorded latencies.
+	 */
+	std::chrono::microseconds percentile(double quantile) const;
+};
+
+/**
+ * \brief Counters of a wire since it was created, taken by SocketWire::Base::get_stats. Traffic counters and
+ * [ack_latency] are collected only if RD_WIRE_STATS is defined, they stay zero otherwise.
+ */
+struct RD_FRAMEWORK_API WireStats
+{
+	uint64_t packages_sent = 0;
+	uint64_t bytes_sent = 0;
+	uint64_t packages_received = 0;
+	uint64_t bytes_received = 0;
+	uint64_t messages_received = 0;
+
+	/**
+	 * \brief Time between sending packages and receiving their acknowledge, i.e. round-trip through both wires.
+	 */
+	LatencyHistogram ack_latency;
+
+	/**
+	 * \brief Misses of the pool are allocations made for outgoing messages.
+	 */
+	ByteArrayPool::Stats send_buffer_pool{};
+};
+
+/**
+ * \brief One line JSON object, suitable for tracking the numbers across runs.
+ */
+std::string RD_FRAMEWORK_API to_string(WireStats const& stats);
+}	 // namespace rd
+
+// define RD_WIRE_STATS to collect WireStats, otherwise clock reads and counters are compiled out of send and receive
+#if defined(RD_WIRE_STATS)
+#define RD_WIRE_STATS_ONLY(...) \
+	do                          \
+	{                           \
+		__VA_ARGS__;            \
+	} while (false)
+#else
+#define RD_WIRE_STATS_ONLY(...) \
+	do                          \
+	{                           \
+	} while (false)
+#endif
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#endif
+
+#endif	  // RD_CPP_WIRESTATS_H
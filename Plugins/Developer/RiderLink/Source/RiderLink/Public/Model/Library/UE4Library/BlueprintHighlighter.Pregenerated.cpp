@@ -8,6 +8,8 @@
 //------------------------------------------------------------------------------
 #include "BlueprintHighlighter.Pregenerated.h"
 
+// Manual post-generation patch, see ../PostGeneration/README.md: integral fields are written with
+// read_varint/write_varint. Reapply PostGeneration/VarintIntegrals.patch after regenerating.
 
 
 #ifdef _MSC_VER
@@ -39,16 +41,16 @@ rd::IPolymorphicSerializable()
 // reader
 BlueprintHighlighter BlueprintHighlighter::read(rd::SerializationCtx& ctx, rd::Buffer & buffer)
 {
-    auto begin_ = buffer.read_integral<int32_t>();
-    auto end_ = buffer.read_integral<int32_t>();
+    auto begin_ = buffer.read_varint<int32_t>();
+    auto end_ = buffer.read_varint<int32_t>();
     BlueprintHighlighter res{std::move(begin_), std::move(end_)};
     return res;
 }
 // writer
 void BlueprintHighlighter::write(rd::SerializationCtx& ctx, rd::Buffer& buffer) const
 {
-    buffer.write_integral(begin_);
-    buffer.write_integral(end_);
+    buffer.write_varint(begin_);
+    buffer.write_varint(end_);
 }
 // virtual init
 // identify
@@ -8,6 +8,8 @@
 //------------------------------------------------------------------------------
 #include "ConnectionInfo.Pregenerated.h"
 
+// Manual post-generation patch, see ../PostGeneration/README.md: integral fields are written with
+// read_varint/write_varint. Reapply PostGeneration/VarintIntegrals.patch after regenerating.
 
 
 #ifdef _MSC_VER
@@ -41,7 +43,7 @@ ConnectionInfo ConnectionInfo::read(rd::SerializationCtx& ctx, rd::Buffer & buff
 {
     auto projectName_ = buffer.read_wstring();
     auto executableName_ = buffer.read_wstring();
-    auto processId_ = buffer.read_integral<int32_t>();
+    auto processId_ = buffer.read_varint<int32_t>();
     ConnectionInfo res{std::move(projectName_), std::move(executableName_), std::move(processId_)};
     return res;
 }
@@ -50,7 +52,7 @@ void ConnectionInfo::write(rd::SerializationCtx& ctx, rd::Buffer& buffer) const
 {
     buffer.write_wstring(projectName_);
     buffer.write_wstring(executableName_);
-    buffer.write_integral(processId_);
+    buffer.write_varint(processId_);
 }
 // virtual init
 // identify
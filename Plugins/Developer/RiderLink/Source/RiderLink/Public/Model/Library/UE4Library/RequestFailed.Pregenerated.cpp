@@ -8,6 +8,8 @@
 //------------------------------------------------------------------------------
 #include "RequestFailed.Pregenerated.h"
 
+// Manual post-generation patch, see ../PostGeneration/README.md: integral fields are written with
+// read_varint/write_varint. Reapply PostGeneration/VarintIntegrals.patch after regenerating.
 
 
 #ifdef _MSC_VER
@@ -39,7 +41,7 @@ RequestResultBase(std::move(requestID_))
 // reader
 RequestFailed RequestFailed::read(rd::SerializationCtx& ctx, rd::Buffer & buffer)
 {
-    auto requestID_ = buffer.read_integral<int32_t>();
+    auto requestID_ = buffer.read_varint<int32_t>();
     auto type_ = rd::Polymorphic<NotificationType>::read(ctx, buffer);
     auto message_ = rd::Polymorphic<FString>::read(ctx, buffer);
     RequestFailed res{std::move(type_), std::move(message_), std::move(requestID_)};
@@ -48,7 +50,7 @@ RequestFailed RequestFailed::read(rd::SerializationCtx& ctx, rd::Buffer & buffer
 // writer
 void RequestFailed::write(rd::SerializationCtx& ctx, rd::Buffer& buffer) const
 {
-    buffer.write_integral(requestID_);
+    buffer.write_varint(requestID_);
     rd::Polymorphic<NotificationType>::write(ctx, buffer, type_);
     rd::Polymorphic<std::decay_t<decltype(message_)>>::write(ctx, buffer, message_);
 }
@@ -8,6 +8,9 @@
 //------------------------------------------------------------------------------
 #include "RequestResultBase.Pregenerated.h"
 
+// Manual post-generation patch, see ../PostGeneration/README.md: integral fields are written with
+// read_varint/write_varint. Reapply PostGeneration/VarintIntegrals.patch after regenerating.
+
 
 #include "RequestResultBase_Unknown.Pregenerated.h"
 
@@ -41,7 +44,7 @@ rd::IPolymorphicSerializable()
 rd::Wrapper<RequestResultBase> RequestResultBase::readUnknownInstance(rd::SerializationCtx& ctx, rd::Buffer & buffer, rd::RdId const& unknownId, int32_t size)
 {
     int32_t objectStartPosition = buffer.get_position();
-    auto requestID_ = buffer.read_integral<int32_t>();
+    auto requestID_ = buffer.read_varint<int32_t>();
     auto unknownBytes = rd::Buffer::ByteArray(objectStartPosition + size - buffer.get_position());
     buffer.read_byte_array_raw(unknownBytes);
     RequestResultBase_Unknown res{std::move(requestID_), unknownId, unknownBytes};
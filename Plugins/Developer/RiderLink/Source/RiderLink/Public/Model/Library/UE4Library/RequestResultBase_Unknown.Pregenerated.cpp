@@ -8,6 +8,8 @@
 //------------------------------------------------------------------------------
 #include "RequestResultBase_Unknown.Pregenerated.h"
 
+// Manual post-generation patch, see ../PostGeneration/README.md: integral fields are written with
+// read_varint/write_varint. Reapply PostGeneration/VarintIntegrals.patch after regenerating.
 
 
 #ifdef _MSC_VER
@@ -44,7 +46,7 @@ RequestResultBase_Unknown RequestResultBase_Unknown::read(rd::SerializationCtx&
 // writer
 void RequestResultBase_Unknown::write(rd::SerializationCtx& ctx, rd::Buffer& buffer) const
 {
-    buffer.write_integral(requestID_);
+    buffer.write_varint(requestID_);
     buffer.write_byte_array_raw(unknownBytes_);
 }
 // virtual init
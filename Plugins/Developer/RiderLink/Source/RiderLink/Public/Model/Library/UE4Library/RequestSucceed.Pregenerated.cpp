@@ -8,6 +8,8 @@
 //------------------------------------------------------------------------------
 #include "RequestSucceed.Pregenerated.h"
 
+// Manual post-generation patch, see ../PostGeneration/README.md: integral fields are written with
+// read_varint/write_varint. Reapply PostGeneration/VarintIntegrals.patch after regenerating.
 
 
 #ifdef _MSC_VER
@@ -39,14 +41,14 @@ RequestResultBase(std::move(requestID_))
 // reader
 RequestSucceed RequestSucceed::read(rd::SerializationCtx& ctx, rd::Buffer & buffer)
 {
-    auto requestID_ = buffer.read_integral<int32_t>();
+    auto requestID_ = buffer.read_varint<int32_t>();
     RequestSucceed res{std::move(requestID_)};
     return res;
 }
 // writer
 void RequestSucceed::write(rd::SerializationCtx& ctx, rd::Buffer& buffer) const
 {
-    buffer.write_integral(requestID_);
+    buffer.write_varint(requestID_);
 }
 // virtual init
 // identify
@@ -8,6 +8,8 @@
 //------------------------------------------------------------------------------
 #include "StringRange.Pregenerated.h"
 
+// Manual post-generation patch, see ../PostGeneration/README.md: integral fields are written with
+// read_varint/write_varint. Reapply PostGeneration/VarintIntegrals.patch after regenerating.
 
 
 #ifdef _MSC_VER
@@ -39,16 +41,16 @@ rd::IPolymorphicSerializable()
 // reader
 StringRange StringRange::read(rd::SerializationCtx& ctx, rd::Buffer & buffer)
 {
-    auto first_ = buffer.read_integral<int32_t>();
-    auto last_ = buffer.read_integral<int32_t>();
+    auto first_ = buffer.read_varint<int32_t>();
+    auto last_ = buffer.read_varint<int32_t>();
     StringRange res{std::move(first_), std::move(last_)};
     return res;
 }
 // writer
 void StringRange::write(rd::SerializationCtx& ctx, rd::Buffer& buffer) const
 {
-    buffer.write_integral(first_);
-    buffer.write_integral(last_);
+    buffer.write_varint(first_);
+    buffer.write_varint(last_);
 }
 // virtual init
 // identify
@@ -48,28 +48,38 @@ namespace EditorPlugin {
 
 UE4Library::UE4LibrarySerializersOwner const UE4Library::serializersOwner;
 
+// BEGIN manual post-generation patch, see ../PostGeneration/README.md
+// RdGen templates aren't part of this tree: serializers are registered through a compile-time table
+// instead of one registry<T>() call per type. Reapply PostGeneration/StaticTypeRegistry.patch after regenerating.
+namespace {
+constexpr auto staticTypes = rd::make_static_type_registry(
+    rd::static_type<StringRange>("StringRange"),
+    rd::static_type<RequestSucceed>("RequestSucceed"),
+    rd::static_type<RequestFailed>("RequestFailed"),
+    rd::static_type<LogMessageInfo>("LogMessageInfo"),
+    rd::static_type<UnrealLogEvent>("UnrealLogEvent"),
+    rd::static_type<UClass>("UClass"),
+    rd::static_type<BlueprintFunction>("BlueprintFunction"),
+    rd::static_type<ScriptCallStackFrame>("ScriptCallStackFrame"),
+    rd::static_type<EmptyScriptCallStack>("EmptyScriptCallStack"),
+    rd::static_type<ScriptCallStack>("ScriptCallStack"),
+    rd::static_type<UnableToDisplayScriptCallStack>("UnableToDisplayScriptCallStack"),
+    rd::static_type<ScriptMsgException>("ScriptMsgException"),
+    rd::static_type<ScriptMsgCallStack>("ScriptMsgCallStack"),
+    rd::static_type<BlueprintHighlighter>("BlueprintHighlighter"),
+    rd::static_type<BlueprintReference>("BlueprintReference"),
+    rd::static_type<ConnectionInfo>("ConnectionInfo"),
+    rd::static_type<RequestResultBase_Unknown>("RequestResultBase_Unknown"),
+    rd::static_type<IScriptCallStack_Unknown>("IScriptCallStack_Unknown"),
+    rd::static_type<IScriptMsg_Unknown>("IScriptMsg_Unknown")
+);
+}
+
 void UE4Library::UE4LibrarySerializersOwner::registerSerializersCore(rd::Serializers const& serializers) const
 {
-    serializers.registry<StringRange>();
-    serializers.registry<RequestSucceed>();
-    serializers.registry<RequestFailed>();
-    serializers.registry<LogMessageInfo>();
-    serializers.registry<UnrealLogEvent>();
-    serializers.registry<UClass>();
-    serializers.registry<BlueprintFunction>();
-    serializers.registry<ScriptCallStackFrame>();
-    serializers.registry<EmptyScriptCallStack>();
-    serializers.registry<ScriptCallStack>();
-    serializers.registry<UnableToDisplayScriptCallStack>();
-    serializers.registry<ScriptMsgException>();
-    serializers.registry<ScriptMsgCallStack>();
-    serializers.registry<BlueprintHighlighter>();
-    serializers.registry<BlueprintReference>();
-    serializers.registry<ConnectionInfo>();
-    serializers.registry<RequestResultBase_Unknown>();
-    serializers.registry<IScriptCallStack_Unknown>();
-    serializers.registry<IScriptMsg_Unknown>();
+    serializers.registry(staticTypes.table());
 }
+// END manual post-generation patch
 
 void UE4Library::connect(rd::Lifetime lifetime, rd::IProtocol const * protocol)
 {
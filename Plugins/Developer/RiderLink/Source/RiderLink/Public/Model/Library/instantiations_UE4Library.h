@@ -7,13 +7,15 @@
 #include "Runtime/Core/Public/Containers/Array.h"
 #include "Runtime/Core/Public/Containers/ContainerAllocationPolicies.h"
 
+// Manual post-generation patch, see PostGeneration/README.md: enums are written with read_varint/write_varint.
+// Reapply PostGeneration/VarintIntegrals.patch after regenerating.
 namespace rd {
 template <>
 class Polymorphic<ELogVerbosity::Type> {
 
 public:
     static ELogVerbosity::Type read(SerializationCtx& ctx, Buffer& buffer) {
-        int32_t x = buffer.read_integral<int32_t>();
+        int32_t x = buffer.read_varint<int32_t>();
         switch (x) {
         case 10:
            return ELogVerbosity::Type::VerbosityMask;
@@ -29,19 +31,19 @@ public:
     static void write(SerializationCtx& ctx, Buffer& buffer, ELogVerbosity::Type const& value) {
         switch (value) {
         case ELogVerbosity::Type::VerbosityMask: {
-           buffer.write_integral<int32_t>(10);
+           buffer.write_varint<int32_t>(10);
            return;
         }
         case ELogVerbosity::Type::SetColor: {
-           buffer.write_integral<int32_t>(11);
+           buffer.write_varint<int32_t>(11);
            return;
         }
         case ELogVerbosity::Type::BreakOnLog: {
-           buffer.write_integral<int32_t>(12);
+           buffer.write_varint<int32_t>(12);
            return;
         }
         default:
-            buffer.write_integral<int32_t>(static_cast<int32_t>(value));
+            buffer.write_varint<int32_t>(static_cast<int32_t>(value));
         }
     }
 };
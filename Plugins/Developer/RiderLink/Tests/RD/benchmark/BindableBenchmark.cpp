@@ -0,0 +1,164 @@
+#include "base/RdBindableBase.h"
+#include "base/WireBase.h"
+#include "protocol/Protocol.h"
+#include "scheduler/SingleThreadScheduler.h"
+#include "lifetime/LifetimeDefinition.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+using clock_type = std::chrono::steady_clock;
+
+constexpr size_t RESOLVES = 10000000;
+constexpr size_t BINDS = 200000;
+
+// resolved addresses are summed and printed so that calls aren't optimized out
+uintptr_t checksum = 0;
+
+/**
+ * \brief Wire dropping everything, entities of the benchmark never send.
+ */
+class NullWire : public WireBase
+{
+public:
+	explicit NullWire(IScheduler* scheduler) : WireBase(scheduler)
+	{
+	}
+
+	void send(RdId const&, std::function<void(Buffer& buffer)>) const override
+	{
+	}
+};
+
+class Node : public RdBindableBase
+{
+};
+
+/**
+ * \brief Resolves protocol and serialization context through its parent on every call, like RdBindableBase did
+ * before caching them at bind.
+ */
+class ForwardingNode : public IRdDynamic
+{
+	IRdDynamic const* parent;
+	RName location;
+
+public:
+	explicit ForwardingNode(IRdDynamic const* parent) : parent(parent), location(parent->get_location().sub("node", "."))
+	{
+	}
+
+	IProtocol const* get_protocol() const override
+	{
+		return parent->get_protocol();
+	}
+
+	SerializationCtx& get_serialization_context() const override
+	{
+		return parent->get_serialization_context();
+	}
+
+	RName const& get_location() const override
+	{
+		return location;
+	}
+};
+
+double nanoseconds_per(clock_type::duration duration, size_t operations)
+{
+	return std::chrono::duration<double, std::nano>(duration).count() / static_cast<double>(operations);
+}
+
+/**
+ * \brief One get_protocol() and one get_serialization_context() call through IRdDynamic, what every sent message
+ * does, in nanoseconds.
+ */
+double resolve(IRdDynamic const* entity)
+{
+	// read through volatile on every iteration, so that the calls aren't hoisted out of the loop
+	IRdDynamic const* volatile target = entity;
+	const auto start = clock_type::now();
+	for (size_t i = 0; i < RESOLVES; ++i)
+	{
+		IRdDynamic const* current = target;
+		checksum += reinterpret_cast<uintptr_t>(current->get_protocol());
+		checksum += reinterpret_cast<uintptr_t>(&current->get_serialization_context());
+	}
+	return nanoseconds_per(clock_type::now() - start, RESOLVES);
+}
+
+/**
+ * \brief Bind of an entity to [parent] and its unbind, in nanoseconds.
+ */
+double bind(Lifetime lifetime, IRdDynamic const* parent)
+{
+	Node node;
+	const auto start = clock_type::now();
+	for (size_t i = 0; i < BINDS; ++i)
+	{
+		LifetimeDefinition definition(lifetime);
+		node.bind(definition.lifetime, parent, "leaf");
+		definition.terminate();
+	}
+	return nanoseconds_per(clock_type::now() - start, BINDS);
+}
+}	 // namespace
+
+/**
+ * \brief Cost of resolving protocol and serialization context of entities nested at different depths, cached at bind
+ * versus forwarded through the parent chain, and the cost of bind it moves the resolution to.
+ */
+int main()
+{
+	LifetimeDefinition definition(Lifetime::Eternal());
+	SingleThreadScheduler scheduler(definition.lifetime, "BindableBenchmark");
+	Protocol protocol(Identities::SERVER, &scheduler, std::make_shared<NullWire>(&scheduler), definition.lifetime);
+
+	// protocol is bound to the scheduler, entities must be bound on its thread
+	scheduler.queue([&] {
+		std::cout << std::left << std::setw(8) << "depth" << std::right << std::setw(14) << "cached" << std::setw(14)
+				  << "parent walk" << std::setw(14) << "bind" << std::endl;
+		for (size_t depth : {1, 2, 5, 10})
+		{
+			std::vector<std::unique_ptr<Node>> chain;
+			std::vector<std::unique_ptr<ForwardingNode>> forwarding;
+			LifetimeDefinition chain_definition(definition.lifetime);
+			IRdDynamic const* parent = &protocol;
+			IRdDynamic const* forwarding_parent = &protocol;
+			// parent of the last node, a leaf bound to it has the same depth
+			IRdDynamic const* leaf_parent = nullptr;
+			for (size_t i = 0; i < depth; ++i)
+			{
+				leaf_parent = parent;
+				chain.push_back(std::unique_ptr<Node>(new Node()));
+				chain.back()->bind(chain_definition.lifetime, parent, "node" + std::to_string(i));
+				parent = chain.back().get();
+
+				forwarding.push_back(std::unique_ptr<ForwardingNode>(new ForwardingNode(forwarding_parent)));
+				forwarding_parent = forwarding.back().get();
+			}
+
+			const double cached = resolve(parent);
+			const double walk = resolve(forwarding_parent);
+			const double bound = bind(chain_definition.lifetime, leaf_parent);
+			std::cout << std::left << std::setw(8) << depth << std::right << std::fixed << std::setprecision(1)
+					  << std::setw(11) << cached << " ns" << std::setw(11) << walk << " ns" << std::setw(11) << bound << " ns"
+					  << std::endl;
+			chain_definition.terminate();
+		}
+	});
+	scheduler.flush();
+	std::cout << "checksum: " << checksum << std::endl;
+
+	definition.terminate();
+	return 0;
+}
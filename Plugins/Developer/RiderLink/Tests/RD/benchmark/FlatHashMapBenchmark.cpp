@@ -0,0 +1,106 @@
+#include "std/flat_hash_map.h"
+#include "std/unordered_map.h"
+#include "protocol/RdId.h"
+#include "thirdparty.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+using clock_type = std::chrono::steady_clock;
+
+constexpr size_t PROBES = 1000000;
+constexpr int LOOKUP_ROUNDS = 20;
+constexpr size_t CHURN_OPERATIONS = 2000000;
+// count of requests in flight for insert/erase churn like the one of RdEndpoint
+constexpr size_t CHURN_WINDOW = 64;
+
+// sum of found values, printed so that lookups aren't optimized out
+int64_t checksum = 0;
+
+double nanoseconds_per(clock_type::duration duration, size_t operations)
+{
+	return std::chrono::duration<double, std::nano>(duration).count() / static_cast<double>(operations);
+}
+
+/**
+ * \brief Random lookups of [probes] in a map of [ids], then insert/erase churn, in nanoseconds per operation.
+ */
+template <typename Map>
+void run(char const* name, std::vector<RdId> const& ids, std::vector<RdId> const& probes)
+{
+	Map map;
+	for (size_t i = 0; i < ids.size(); ++i)
+	{
+		map.emplace(ids[i], static_cast<int32_t>(i));
+	}
+
+	auto start = clock_type::now();
+	for (int round = 0; round < LOOKUP_ROUNDS; ++round)
+	{
+		for (auto const& id : probes)
+		{
+			auto it = map.find(id);
+			if (it != map.end())
+			{
+				checksum += it->second;
+			}
+		}
+	}
+	const double lookup = nanoseconds_per(clock_type::now() - start, LOOKUP_ROUNDS * probes.size());
+
+	Map churn;
+	start = clock_type::now();
+	for (size_t i = 0; i < CHURN_OPERATIONS; ++i)
+	{
+		churn.emplace(RdId(static_cast<int64_t>(i) * 2 + 1), 1);
+		if (i >= CHURN_WINDOW)
+		{
+			churn.erase(RdId(static_cast<int64_t>(i - CHURN_WINDOW) * 2 + 1));
+		}
+	}
+	const double insert_erase = nanoseconds_per(clock_type::now() - start, CHURN_OPERATIONS);
+
+	std::cout << "  " << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(1)
+			  << " lookup " << std::setw(6) << lookup << " ns, insert/erase " << std::setw(6) << insert_erase << " ns"
+			  << std::endl;
+}
+}	 // namespace
+
+/**
+ * \brief Compares flat_hash_map with the maps it replaced for RdId keys: lookups in maps of different sizes, from
+ * L1-resident to cache-missing, and insert/erase churn.
+ */
+int main()
+{
+	std::mt19937_64 random(42);
+	for (size_t size : {16, 1000, 100000})
+	{
+		std::vector<RdId> ids;
+		ids.reserve(size);
+		for (size_t i = 0; i < size; ++i)
+		{
+			ids.push_back(RdId::Null().mix("entity").mix(static_cast<int64_t>(i)));
+		}
+		std::vector<RdId> probes;
+		probes.reserve(PROBES);
+		for (size_t i = 0; i < PROBES; ++i)
+		{
+			probes.push_back(ids[random() % size]);
+		}
+
+		std::cout << "ids: " << size << std::endl;
+		run<rd::unordered_map<RdId, int32_t>>("unordered_map", ids, probes);
+		run<tsl::ordered_map<RdId, int32_t, rd::hash<RdId>>>("ordered_map", ids, probes);
+		run<flat_hash_map<RdId, int32_t>>("flat_hash_map", ids, probes);
+	}
+	std::cout << "checksum: " << checksum << std::endl;
+	return 0;
+}
@@ -0,0 +1,306 @@
+#include "wire/SocketWire.h"
+#include "protocol/Protocol.h"
+#include "impl/RdSignal.h"
+#include "impl/RdProperty.h"
+#include "task/RdCall.h"
+#include "task/RdEndpoint.h"
+#include "scheduler/SingleThreadScheduler.h"
+#include "lifetime/LifetimeDefinition.h"
+
+#include "support/AllocationCounter.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace rd;
+
+namespace
+{
+using clock_type = std::chrono::steady_clock;
+
+/**
+ * \brief Counter the main thread waits on until handlers running on the schedulers reach a value.
+ */
+class Latch
+{
+	std::mutex lock;
+	std::condition_variable cv;
+	int64_t count = 0;
+
+public:
+	void add()
+	{
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			++count;
+		}
+		cv.notify_all();
+	}
+
+	bool wait_for(int64_t value, std::chrono::seconds timeout = std::chrono::seconds(30))
+	{
+		std::unique_lock<std::mutex> ul(lock);
+		return cv.wait_for(ul, timeout, [&] { return count >= value; });
+	}
+
+	int64_t get()
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		return count;
+	}
+};
+
+/**
+ * \brief Measures the time and allocations between its construction and [report].
+ */
+class Measurement
+{
+	std::string name;
+	clock_type::time_point start = clock_type::now();
+	uint64_t start_allocations = bench::allocation_count();
+
+public:
+	explicit Measurement(std::string name) : name(std::move(name))
+	{
+	}
+
+	void report(int64_t messages) const
+	{
+		const double seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+		const double allocated = static_cast<double>(bench::allocation_count() - start_allocations);
+		std::cout << std::left << std::setw(24) << name << std::right << std::setw(10) << messages << " msgs"
+				  << std::setw(12) << std::fixed << std::setprecision(0) << messages / seconds << " msgs/s" << std::setw(10)
+				  << std::setprecision(2) << seconds * 1e6 / messages << " us/msg" << std::setw(10) << allocated / messages
+				  << " allocs/msg" << std::endl;
+	}
+};
+
+/**
+ * \brief Server and client protocols connected through a local socket, each with a scheduler of its own.
+ */
+struct ProtocolPair
+{
+	LifetimeDefinition definition{Lifetime::Eternal()};
+	Lifetime lifetime = definition.lifetime;
+	SingleThreadScheduler server_scheduler{lifetime, "BenchmarkServer"};
+	SingleThreadScheduler client_scheduler{lifetime, "BenchmarkClient"};
+	std::shared_ptr<SocketWire::Server> server_wire =
+		std::make_shared<SocketWire::Server>(lifetime, &server_scheduler, 0, "BenchmarkServerWire");
+	std::shared_ptr<SocketWire::Client> client_wire =
+		std::make_shared<SocketWire::Client>(lifetime, &client_scheduler, server_wire->port, "BenchmarkClientWire");
+	Protocol server{Identities::SERVER, &server_scheduler, server_wire, lifetime};
+	Protocol client{Identities::CLIENT, &client_scheduler, client_wire, lifetime};
+
+	void wait_connected() const
+	{
+		while (!server_wire->connected.get() || !client_wire->connected.get())
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+	}
+
+	~ProtocolPair()
+	{
+		definition.terminate();
+	}
+};
+
+/**
+ * \brief Lifetimes entities of one scenario are bound to on each side, they're unbound on the owning schedulers
+ * before the entities go out of scope.
+ */
+class Scenario
+{
+	ProtocolPair& pair;
+	LifetimeDefinition server_definition;
+	LifetimeDefinition client_definition;
+
+public:
+	Lifetime server = server_definition.lifetime;
+	Lifetime client = client_definition.lifetime;
+
+	explicit Scenario(ProtocolPair& pair)
+		: pair(pair), server_definition(pair.lifetime), client_definition(pair.lifetime)
+	{
+	}
+
+	~Scenario()
+	{
+		pair.server_scheduler.queue([this] { server_definition.terminate(); });
+		pair.client_scheduler.queue([this] { client_definition.terminate(); });
+		pair.server_scheduler.flush();
+		pair.client_scheduler.flush();
+	}
+};
+
+// server fires as fast as it can, measured until the client has received everything
+void signal_throughput(ProtocolPair& pair, int32_t count)
+{
+	RdSignal<int32_t> source, sink;
+	statics(source, 1);
+	statics(sink, 1);
+	Scenario scenario(pair);
+	Latch received;
+	pair.server_scheduler.queue([&] { source.bind(scenario.server, &pair.server, "signal_throughput"); });
+	pair.client_scheduler.queue([&] {
+		sink.bind(scenario.client, &pair.client, "signal_throughput");
+		sink.advise(scenario.client, [&](int32_t const&) { received.add(); });
+	});
+	pair.server_scheduler.flush();
+	pair.client_scheduler.flush();
+
+	Measurement measurement("signal throughput");
+	pair.server_scheduler.queue([&] {
+		for (int32_t i = 0; i < count; ++i)
+		{
+			source.fire(i);
+		}
+	});
+	if (!received.wait_for(count))
+	{
+		std::cerr << "signal throughput: received " << received.get() << " of " << count << std::endl;
+		std::exit(1);
+	}
+	measurement.report(count);
+}
+
+// client fires a ping, server answers with a pong, the next ping is fired on pong
+void signal_round_trip(ProtocolPair& pair, int32_t count)
+{
+	RdSignal<int32_t> client_ping, server_ping, server_pong, client_pong;
+	statics(client_ping, 2);
+	statics(server_ping, 2);
+	statics(server_pong, 3);
+	statics(client_pong, 3);
+	Scenario scenario(pair);
+	Latch completed;
+	pair.server_scheduler.queue([&] {
+		server_ping.bind(scenario.server, &pair.server, "ping");
+		server_pong.bind(scenario.server, &pair.server, "pong");
+		server_ping.advise(scenario.server, [&](int32_t const& value) { server_pong.fire(value); });
+	});
+	pair.client_scheduler.queue([&] {
+		client_ping.bind(scenario.client, &pair.client, "ping");
+		client_pong.bind(scenario.client, &pair.client, "pong");
+		client_pong.advise(scenario.client, [&](int32_t const& value) {
+			completed.add();
+			if (value + 1 < count)
+			{
+				client_ping.fire(value + 1);
+			}
+		});
+	});
+	pair.server_scheduler.flush();
+	pair.client_scheduler.flush();
+
+	Measurement measurement("signal round-trip");
+	pair.client_scheduler.queue([&] { client_ping.fire(0); });
+	if (!completed.wait_for(count))
+	{
+		std::cerr << "signal round-trip: completed " << completed.get() << " of " << count << std::endl;
+		std::exit(1);
+	}
+	measurement.report(count);
+}
+
+// server changes the property, measured until the client has seen the last value
+void property_throughput(ProtocolPair& pair, int32_t count)
+{
+	RdProperty<int32_t> source(0), sink(0);
+	statics(source, 4);
+	statics(sink, 4);
+	Scenario scenario(pair);
+	Latch last;
+	pair.server_scheduler.queue([&] { source.bind(scenario.server, &pair.server, "property"); });
+	pair.client_scheduler.queue([&] {
+		sink.bind(scenario.client, &pair.client, "property");
+		sink.advise(scenario.client, [&](int32_t const& value) {
+			if (value == count)
+			{
+				last.add();
+			}
+		});
+	});
+	pair.server_scheduler.flush();
+	pair.client_scheduler.flush();
+
+	Measurement measurement("property throughput");
+	pair.server_scheduler.queue([&] {
+		for (int32_t i = 1; i <= count; ++i)
+		{
+			source.set(i);
+		}
+	});
+	if (!last.wait_for(1))
+	{
+		std::cerr << "property throughput: last value wasn't received" << std::endl;
+		std::exit(1);
+	}
+	measurement.report(count);
+}
+
+// client calls the endpoint synchronously one call after another
+void call_round_trip(ProtocolPair& pair, int32_t count)
+{
+	RdEndpoint<int32_t, int32_t> endpoint;
+	RdCall<int32_t, int32_t> call;
+	statics(endpoint, 5);
+	statics(call, 5);
+	endpoint.set([](int32_t const& value) { return value + 1; });
+	Scenario scenario(pair);
+	pair.server_scheduler.queue([&] { endpoint.bind(scenario.server, &pair.server, "call"); });
+	pair.client_scheduler.queue([&] { call.bind(scenario.client, &pair.client, "call"); });
+	pair.server_scheduler.flush();
+	pair.client_scheduler.flush();
+
+	Latch completed;
+	Measurement measurement("call round-trip");
+	pair.client_scheduler.queue([&] {
+		for (int32_t i = 0; i < count; ++i)
+		{
+			if (call.sync(i, std::chrono::milliseconds(10000)).value_or_throw().unwrap() != i + 1)
+			{
+				std::cerr << "call round-trip: wrong result" << std::endl;
+				std::exit(1);
+			}
+			completed.add();
+		}
+	});
+	if (!completed.wait_for(count))
+	{
+		std::cerr << "call round-trip: completed " << completed.get() << " of " << count << std::endl;
+		std::exit(1);
+	}
+	measurement.report(count);
+}
+}	 // namespace
+
+/**
+ * \brief Throughput, latency and allocations per message of a Protocol pair connected over SocketWire.
+ * Optional argument scales the number of messages, 1 by default.
+ */
+int main(int argc, char* argv[])
+{
+	spdlog::set_level(spdlog::level::err);
+	const int32_t scale = argc > 1 ? (std::max)(1, std::atoi(argv[1])) : 1;
+
+	ProtocolPair pair;
+	pair.wait_connected();
+
+	signal_throughput(pair, 200000 * scale);
+	signal_round_trip(pair, 20000 * scale);
+	property_throughput(pair, 200000 * scale);
+	call_round_trip(pair, 20000 * scale);
+
+#if defined(RD_WIRE_STATS)
+	std::cout << "server: " << to_string(pair.server_wire->get_stats()) << std::endl;
+	std::cout << "client: " << to_string(pair.client_wire->get_stats()) << std::endl;
+#endif
+	return 0;
+}
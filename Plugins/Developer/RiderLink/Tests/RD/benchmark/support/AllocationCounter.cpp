@@ -0,0 +1,41 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<uint64_t> allocations{0};
+}	 // namespace
+
+void* operator new(size_t size)
+{
+	++allocations;
+	if (void* p = std::malloc(size == 0 ? 1 : size))
+	{
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	std::free(p);
+}
+
+namespace rd
+{
+namespace bench
+{
+uint64_t allocation_count()
+{
+	return allocations;
+}
+}	 // namespace bench
+}	 // namespace rd
@@ -0,0 +1,19 @@
+#ifndef RD_TESTS_ALLOCATIONCOUNTER_H
+#define RD_TESTS_ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+namespace rd
+{
+namespace bench
+{
+/**
+ * \brief Allocations made by the global operator new so far by all threads, i.e. by both sides of a connection.
+ * The replaced operators live in their own translation unit, so that new and delete expressions of a benchmark
+ * aren't checked against malloc and free.
+ */
+uint64_t allocation_count();
+}	 // namespace bench
+}	 // namespace rd
+
+#endif	  // RD_TESTS_ALLOCATIONCOUNTER_H
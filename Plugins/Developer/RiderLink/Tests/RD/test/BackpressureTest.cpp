@@ -0,0 +1,164 @@
+#include "wire/ByteBufferAsyncProcessor.h"
+#include "wire/SocketWire.h"
+#include "protocol/Protocol.h"
+#include "ext/RdExtBase.h"
+#include "impl/RdSignal.h"
+#include "scheduler/SingleThreadScheduler.h"
+#include "lifetime/LifetimeDefinition.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+// put of the receiving thread passes the limit, puts of other threads wait for acknowledge
+bool put_does_not_block_receiving_thread()
+{
+	ByteBufferAsyncProcessor processor("BackpressureTest", [](ByteBufferAsyncProcessor::batch_t const&, sequence_number_t) { return true; });
+	processor.set_max_unacknowledged_bytes(1);
+	// started paused like the processor of SocketWire
+	processor.pause("initial");
+	processor.start();
+	processor.resume();
+	processor.put(Buffer::ByteArray(16));
+
+	// receiving thread stays alive until the end, so that its id isn't reused by the other thread
+	std::promise<void> finished;
+	std::promise<void> put_done;
+	std::thread receiving([&] {
+		processor.set_receiving_thread(std::this_thread::get_id());
+		processor.put(Buffer::ByteArray(16));
+		put_done.set_value();
+		finished.get_future().wait();
+	});
+	bool ok = put_done.get_future().wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+	if (!ok)
+	{
+		std::cerr << "put_does_not_block_receiving_thread: receiving thread is blocked" << std::endl;
+		std::_Exit(1);
+	}
+
+	auto other = std::async(std::launch::async, [&] { processor.put(Buffer::ByteArray(16)); });
+	if (other.wait_for(std::chrono::milliseconds(100)) == std::future_status::ready)
+	{
+		std::cerr << "put_does_not_block_receiving_thread: put over the limit didn't wait" << std::endl;
+		ok = false;
+	}
+	processor.acknowledge(2);
+	if (other.wait_for(std::chrono::seconds(5)) != std::future_status::ready)
+	{
+		std::cerr << "put_does_not_block_receiving_thread: put wasn't released by acknowledge" << std::endl;
+		std::_Exit(1);
+	}
+	finished.set_value();
+	receiving.join();
+	processor.terminate();
+	return ok;
+}
+
+/**
+ * \brief Ext recording the states received from its counterpart.
+ */
+class RecordingExt : public RdExtBase
+{
+public:
+	mutable std::atomic<int32_t> received{0};
+
+	void on_wire_received(Buffer buffer) const override
+	{
+		++received;
+		RdExtBase::on_wire_received(std::move(buffer));
+	}
+};
+
+// ext answers the counterpart's Ready from the receiving thread while the wire is over its limit of not acknowledged
+// bytes, the answer mustn't wait for acknowledges only that thread reads
+bool ext_handshake_over_limit()
+{
+	constexpr int32_t COUNT = 3000;
+
+	LifetimeDefinition definition(Lifetime::Eternal());
+	Lifetime lifetime = definition.lifetime;
+	SingleThreadScheduler server_scheduler(lifetime, "BackpressureServer");
+	SingleThreadScheduler client_scheduler(lifetime, "BackpressureClient");
+	auto server_wire = std::make_shared<SocketWire::Server>(lifetime, &server_scheduler, 0, "BackpressureServerWire");
+	auto client_wire = std::make_shared<SocketWire::Client>(lifetime, &client_scheduler, server_wire->port, "BackpressureClientWire");
+	Protocol server(Identities::SERVER, &server_scheduler, server_wire, lifetime);
+	Protocol client(Identities::CLIENT, &client_scheduler, client_wire, lifetime);
+	// any package in flight fills the limit
+	server_wire->set_max_unacknowledged_bytes(1);
+
+	RecordingExt server_ext, client_ext;
+	statics(server_ext, 1);
+	statics(client_ext, 1);
+	RdSignal<std::wstring> source, sink;
+	statics(source, 2);
+	statics(sink, 2);
+	std::atomic<int32_t> received{0};
+
+	while (!server_wire->connected.get() || !client_wire->connected.get())
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	server_scheduler.queue([&] {
+		server_ext.bind(lifetime, &server, "ext");
+		source.bind(lifetime, &server, "signal");
+	});
+	client_scheduler.queue([&] {
+		sink.bind(lifetime, &client, "signal");
+		sink.advise(lifetime, [&](std::wstring const&) { ++received; });
+	});
+	server_scheduler.flush();
+	client_scheduler.flush();
+
+	// every put of the server scheduler waits for acknowledge of the previous package
+	server_scheduler.queue([&] {
+		for (int32_t i = 0; i < COUNT; ++i)
+		{
+			source.fire(std::wstring(256, L'x'));
+		}
+	});
+	while (received < COUNT / 10)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	// Ready of the client is handled by the server's receiving thread, which sends ReceivedCounterpart
+	client_scheduler.queue([&] { client_ext.bind(lifetime, &client, "ext"); });
+
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+	// Ready of the server sent before the client has bound its ext is dropped
+	while (received < COUNT || server_ext.received == 0 || client_ext.received == 0)
+	{
+		if (std::chrono::steady_clock::now() > deadline)
+		{
+			std::cerr << "ext_handshake_over_limit: wire is stuck, received " << received << " of " << COUNT
+					  << ", ext states " << server_ext.received << "/" << client_ext.received << std::endl;
+			// wires can't be stopped while one of them is deadlocked
+			std::_Exit(1);
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	definition.terminate();
+	return true;
+}
+}	 // namespace
+
+int main()
+{
+	spdlog::set_level(spdlog::level::err);
+	bool ok = true;
+	ok &= put_does_not_block_receiving_thread();
+	ok &= ext_handshake_over_limit();
+	std::cout << (ok ? "OK" : "FAILED") << std::endl;
+	return ok ? 0 : 1;
+}
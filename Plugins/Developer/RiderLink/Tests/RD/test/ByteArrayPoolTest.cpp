@@ -0,0 +1,81 @@
+#include "wire/ByteArrayPool.h"
+
+#include <iostream>
+#include <string>
+
+using namespace rd;
+
+namespace
+{
+bool ok = true;
+
+void check(bool condition, std::string const& message)
+{
+	if (!condition)
+	{
+		std::cerr << message << std::endl;
+		ok = false;
+	}
+}
+
+Buffer::ByteArray array_of_capacity(size_t capacity)
+{
+	Buffer::ByteArray array;
+	array.reserve(capacity);
+	return array;
+}
+
+void small_request_does_not_take_large_array()
+{
+	ByteArrayPool pool;
+	pool.release(array_of_capacity(1024 * 1024));
+	auto array = pool.acquire(256);
+	check(array.size() == 256, "small request: size " + std::to_string(array.size()));
+	check(array.capacity() < 1024 * 1024, "small request took the pooled 1 MiB array");
+	check(pool.get_stats().misses == 1, "small request: expected a miss");
+}
+
+void request_takes_matching_or_next_class()
+{
+	ByteArrayPool pool;
+	pool.release(array_of_capacity(512));
+	auto next = pool.acquire(256);
+	check(next.size() == 256 && next.capacity() >= 512, "next class: array wasn't reused");
+	pool.release(array_of_capacity(256));
+	auto matching = pool.acquire(200);
+	check(matching.size() == 200 && matching.capacity() >= 256, "matching class: array wasn't reused");
+	check(pool.get_stats().hits == 2, "matching or next class: expected two hits");
+}
+
+void request_is_never_smaller_than_asked()
+{
+	ByteArrayPool pool;
+	pool.release(array_of_capacity(256));
+	auto array = pool.acquire(300);
+	check(array.size() == 300 && array.capacity() >= 300, "class above the pooled one: too small array");
+
+	pool.release(array_of_capacity(1024 * 1024));
+	auto large = pool.acquire(3 * 1024 * 1024);
+	check(large.size() == 3 * 1024 * 1024, "request above the largest class: size " + std::to_string(large.size()));
+}
+
+void released_array_returns_to_its_class()
+{
+	ByteArrayPool pool;
+	auto array = pool.acquire(1000);
+	array.resize(2000);
+	pool.release(std::move(array));
+	auto reused = pool.acquire(1000);
+	check(pool.get_stats().hits == 1 && reused.size() == 1000, "array grown within its capacity wasn't reused");
+}
+}	 // namespace
+
+int main()
+{
+	small_request_does_not_take_large_array();
+	request_takes_matching_or_next_class();
+	request_is_never_smaller_than_asked();
+	released_array_returns_to_its_class();
+	std::cout << (ok ? "OK" : "FAILED") << std::endl;
+	return ok ? 0 : 1;
+}
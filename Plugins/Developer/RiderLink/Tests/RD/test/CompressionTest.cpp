@@ -0,0 +1,150 @@
+#include "util/compression.h"
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+using Bytes = std::vector<uint8_t>;
+
+Bytes compress(Bytes const& raw)
+{
+	Bytes compressed(util::lz4_compress_bound(raw.size()));
+	compressed.resize(util::lz4_compress(raw.data(), raw.size(), compressed.data(), compressed.size()));
+	return compressed;
+}
+
+bool decompress(Bytes const& compressed, Bytes& raw, size_t raw_size)
+{
+	raw.assign(raw_size, 0);
+	return util::lz4_decompress(compressed.data(), compressed.size(), raw.data(), raw.size());
+}
+
+bool round_trip(std::string const& name, Bytes const& raw)
+{
+	Bytes compressed = compress(raw);
+	Bytes decompressed;
+	const bool ok = !compressed.empty() && compressed.size() <= util::lz4_compress_bound(raw.size()) &&
+					decompress(compressed, decompressed, raw.size()) && decompressed == raw;
+	if (!ok)
+	{
+		std::cerr << "round_trip " << name << " of " << raw.size() << " bytes failed" << std::endl;
+	}
+	return ok;
+}
+
+Bytes random_bytes(std::mt19937& random, size_t size, int alphabet)
+{
+	std::uniform_int_distribution<int> distribution(0, alphabet - 1);
+	Bytes bytes(size);
+	for (auto& byte : bytes)
+	{
+		byte = static_cast<uint8_t>(distribution(random));
+	}
+	return bytes;
+}
+
+bool round_trips()
+{
+	std::mt19937 random(42);
+	bool ok = true;
+
+	ok &= round_trip("empty", Bytes{});
+	ok &= round_trip("single byte", Bytes{7});
+	// inputs around the length where matches start to be searched for
+	for (size_t size = 1; size <= 20; ++size)
+	{
+		ok &= round_trip("zeros", Bytes(size, 0));
+		ok &= round_trip("random", random_bytes(random, size, 256));
+	}
+	ok &= round_trip("long zeros", Bytes(100000, 0));
+	ok &= round_trip("long random", random_bytes(random, 70000, 256));
+	ok &= round_trip("small alphabet", random_bytes(random, 70000, 4));
+
+	// literal runs of all length encodings between repeated blocks, matches further than the maximum offset
+	Bytes mixed;
+	for (size_t literals : {1, 14, 15, 16, 269, 270, 271, 1000, 70000})
+	{
+		Bytes run = random_bytes(random, literals, 256);
+		mixed.insert(mixed.end(), run.begin(), run.end());
+		mixed.insert(mixed.end(), 300, static_cast<uint8_t>(literals));
+	}
+	ok &= round_trip("mixed", mixed);
+
+	std::string text;
+	while (text.size() < 10000)
+	{
+		text += "{\"id\":" + std::to_string(text.size()) + ",\"name\":\"entity\",\"value\":[1,2,3]}";
+	}
+	ok &= round_trip("text", Bytes(text.begin(), text.end()));
+	return ok;
+}
+
+bool too_small_destination()
+{
+	std::mt19937 random(7);
+	Bytes raw = random_bytes(random, 1000, 256);
+	Bytes compressed(raw.size() / 2);
+	bool ok = util::lz4_compress(raw.data(), raw.size(), compressed.data(), compressed.size()) == 0;
+	ok &= util::lz4_compress(nullptr, 0, nullptr, 0) == 0;
+	if (!ok)
+	{
+		std::cerr << "too_small_destination failed" << std::endl;
+	}
+	return ok;
+}
+
+// corrupted blocks are rejected without reading or writing out of bounds
+bool corrupted_input()
+{
+	std::mt19937 random(13);
+	Bytes raw = random_bytes(random, 5000, 8);
+	Bytes compressed = compress(raw);
+	Bytes decompressed;
+	bool ok = true;
+
+	for (size_t size = 0; size < compressed.size(); ++size)
+	{
+		ok &= !decompress(Bytes(compressed.begin(), compressed.begin() + size), decompressed, raw.size());
+	}
+	ok &= !decompress(compressed, decompressed, raw.size() - 1);
+	ok &= !decompress(compressed, decompressed, raw.size() + 1);
+	ok &= !decompress(compressed, decompressed, 0);
+
+	// flipped bytes either decode to something of the right size or are rejected
+	for (int i = 0; i < 10000; ++i)
+	{
+		Bytes damaged = compressed;
+		damaged[random() % damaged.size()] ^= static_cast<uint8_t>(1 + random() % 255);
+		decompress(damaged, decompressed, raw.size());
+	}
+
+	// a match before the start of the output and a zero offset
+	ok &= !decompress(Bytes{0x10, 'a', 0x02, 0x00, 0x00}, decompressed, 6);
+	ok &= !decompress(Bytes{0x10, 'a', 0x00, 0x00, 0x00}, decompressed, 6);
+	// literals longer than the input
+	ok &= !decompress(Bytes{0xF0, 0xFF, 0xFF}, decompressed, 600);
+	ok &= !decompress(Bytes{0x00}, decompressed, 1);
+	ok &= decompress(Bytes{0x00}, decompressed, 0);
+
+	if (!ok)
+	{
+		std::cerr << "corrupted_input failed" << std::endl;
+	}
+	return ok;
+}
+}	 // namespace
+
+int main()
+{
+	bool ok = true;
+	ok &= round_trips();
+	ok &= too_small_destination();
+	ok &= corrupted_input();
+	std::cout << (ok ? "OK" : "FAILED") << std::endl;
+	return ok ? 0 : 1;
+}
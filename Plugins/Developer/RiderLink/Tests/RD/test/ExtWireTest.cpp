@@ -0,0 +1,91 @@
+#include "ext/ExtWire.h"
+#include "protocol/Buffer.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+/**
+ * \brief Wire recording what it's asked to send, starting every message in fixed width mode like SocketWire does for
+ * counterparts without varint integrals.
+ */
+class RecordingWire : public IWire
+{
+public:
+	struct Sent
+	{
+		Buffer::ByteArray bytes;
+		bool varint_integrals;
+	};
+
+	mutable std::vector<Sent> sent;
+
+	void send(RdId const&, std::function<void(Buffer& buffer)> writer) const override
+	{
+		Buffer buffer;
+		buffer.set_varint_integrals(false);
+		writer(buffer);
+		const bool varint_integrals = buffer.varint_integrals();
+		sent.push_back(Sent{std::move(buffer).getRealArray(), varint_integrals});
+	}
+
+	void advise(Lifetime, RdReactiveBase const*) const override
+	{
+	}
+};
+
+void write_payload(Buffer& buffer)
+{
+	buffer.write_varint<int64_t>(-300);
+	buffer.write_varint<int32_t>(1 << 20);
+}
+
+Buffer::ByteArray write(bool varint_integrals)
+{
+	Buffer buffer;
+	buffer.set_varint_integrals(varint_integrals);
+	write_payload(buffer);
+	return std::move(buffer).getRealArray();
+}
+
+// messages queued while disconnected are replayed in the mode their writer has chosen
+bool replays_in_written_mode()
+{
+	RecordingWire real_wire;
+	ExtWire wire;
+	wire.realWire = &real_wire;
+
+	bool ok = !wire.varint_integrals();
+	for (bool varint_integrals : {true, false})
+	{
+		wire.send(RdId(1), [varint_integrals](Buffer& buffer) {
+			buffer.set_varint_integrals(varint_integrals);
+			write_payload(buffer);
+		});
+	}
+	ok &= real_wire.sent.empty();
+
+	wire.connected.set(true);
+	ok &= real_wire.sent.size() == 2;
+	if (ok)
+	{
+		ok &= real_wire.sent[0].varint_integrals && real_wire.sent[0].bytes == write(true);
+		ok &= !real_wire.sent[1].varint_integrals && real_wire.sent[1].bytes == write(false);
+	}
+	if (!ok)
+	{
+		std::cerr << "replays_in_written_mode: queued messages weren't replayed in their mode" << std::endl;
+	}
+	return ok;
+}
+}	 // namespace
+
+int main()
+{
+	const bool ok = replays_in_written_mode();
+	std::cout << (ok ? "OK" : "FAILED") << std::endl;
+	return ok ? 0 : 1;
+}
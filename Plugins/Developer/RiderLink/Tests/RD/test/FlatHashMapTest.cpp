@@ -0,0 +1,117 @@
+#include "std/flat_hash_map.h"
+#include "protocol/RdId.h"
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+using namespace rd;
+
+namespace
+{
+// random operations applied to flat_hash_map and std::unordered_map must give the same contents
+bool same_as_unordered_map(int round, std::mt19937_64& random)
+{
+	flat_hash_map<RdId, std::string> map;
+	std::unordered_map<int64_t, std::string> expected;
+	const int64_t range = 10 + round * 300;
+	// odd rounds use keys differing in high bits only
+	const int64_t multiplier = round % 2 ? 1 : 0x100000001LL;
+
+	for (int operation = 0; operation < 200000; ++operation)
+	{
+		const int64_t key = static_cast<int64_t>(random() % range) * multiplier;
+		switch (random() % 5)
+		{
+			case 0:
+			case 1:
+			{
+				auto value = std::to_string(operation);
+				if (map.emplace(RdId(key), value).second != expected.emplace(key, value).second)
+				{
+					return false;
+				}
+				break;
+			}
+			case 2:
+				if (map.erase(RdId(key)) != expected.erase(key))
+				{
+					return false;
+				}
+				break;
+			case 3:
+			{
+				auto it = map.find(RdId(key));
+				auto jt = expected.find(key);
+				if ((it == map.end()) != (jt == expected.end()) || (jt != expected.end() && it->second != jt->second))
+				{
+					return false;
+				}
+				break;
+			}
+			default:
+				if (random() % 1000 == 0)
+				{
+					map.clear();
+					expected.clear();
+				}
+				else if (random() % 3 == 0 && !map.empty())
+				{
+					auto it = map.begin();
+					expected.erase(it->first.get_hash());
+					map.erase(it);
+				}
+				break;
+		}
+		if (map.size() != expected.size())
+		{
+			return false;
+		}
+	}
+
+	size_t count = 0;
+	for (auto const& entry : map)
+	{
+		++count;
+		auto jt = expected.find(entry.first.get_hash());
+		if (jt == expected.end() || jt->second != entry.second)
+		{
+			return false;
+		}
+	}
+	if (count != expected.size())
+	{
+		return false;
+	}
+
+	auto copy = map;
+	auto moved = std::move(copy);
+	for (auto const& entry : map)
+	{
+		auto it = moved.find(entry.first);
+		if (it == moved.end() || it->second != entry.second)
+		{
+			return false;
+		}
+	}
+	return moved.size() == map.size();
+}
+}	 // namespace
+
+int main()
+{
+	std::mt19937_64 random(42);
+	for (int round = 0; round < 20; ++round)
+	{
+		if (!same_as_unordered_map(round, random))
+		{
+			std::cerr << "flat_hash_map differs from std::unordered_map in round " << round << std::endl;
+			std::cout << "FAILED" << std::endl;
+			return 1;
+		}
+	}
+	std::cout << "OK" << std::endl;
+	return 0;
+}
@@ -0,0 +1,157 @@
+#include "intern/ConcurrentIndexMap.h"
+#include "intern/SegmentedArray.h"
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+bool report(std::string const& name, bool ok)
+{
+	if (!ok)
+	{
+		std::cerr << name << " failed" << std::endl;
+	}
+	return ok;
+}
+
+// readers see either nothing or the value written at an index while the array grows
+bool segmented_array_concurrent_reads()
+{
+	constexpr size_t COUNT = 200000;
+	constexpr int READERS = 4;
+
+	SegmentedArray<size_t> array;
+	std::atomic<bool> done{false};
+	std::atomic<bool> mismatch{false};
+
+	std::vector<std::thread> readers;
+	for (int r = 0; r < READERS; ++r)
+	{
+		readers.emplace_back([&, r] {
+			size_t index = r;
+			while (!done)
+			{
+				index = (index * 7 + 13) % COUNT;
+				size_t const* value = array.get(index);
+				if (value != nullptr && *value != index)
+				{
+					mismatch = true;
+				}
+			}
+		});
+	}
+	bool ok = true;
+	for (size_t i = 0; i < COUNT; ++i)
+	{
+		ok &= array.push_back(i) == i;
+	}
+	done = true;
+	for (auto& reader : readers)
+	{
+		reader.join();
+	}
+
+	for (size_t i = 0; ok && i < COUNT; ++i)
+	{
+		ok = array.get(i) != nullptr && *array.get(i) == i;
+	}
+	return report("segmented_array_concurrent_reads", ok && !mismatch);
+}
+
+// an index far beyond the elements set so far is rejected instead of allocating a huge segment
+bool segmented_array_rejects_implausible_index()
+{
+	SegmentedArray<int> array;
+	bool ok = !array.set(size_t(1) << 30, 1) && array.get(size_t(1) << 30) == nullptr;
+	ok &= !array.set(64, 1);
+	ok &= array.set(63, 1) && array.set(0, 2);
+	// 2 elements set, the bound is 64 + 2 * 2
+	ok &= array.set(67, 3) && !array.set(67, 4) && *array.get(67) == 3;
+	ok &= !array.set(70, 5);
+	ok &= !array.set(static_cast<size_t>(-1), 6);
+	return report("segmented_array_rejects_implausible_index", ok);
+}
+
+// keys inserted by concurrent writers are found by readers with the index they were inserted with
+bool index_map_concurrent_inserts()
+{
+	constexpr int32_t PER_WRITER = 50000;
+	constexpr int32_t WRITERS = 4;
+	constexpr int READERS = 2;
+
+	ConcurrentIndexMap<int64_t> map;
+	std::atomic<bool> done{false};
+	std::atomic<bool> mismatch{false};
+
+	std::vector<std::thread> readers;
+	for (int r = 0; r < READERS; ++r)
+	{
+		readers.emplace_back([&, r] {
+			int64_t key = r;
+			while (!done)
+			{
+				key = (key * 7 + 13) % (PER_WRITER * WRITERS);
+				auto index = map.find(key);
+				if (index && *index != key)
+				{
+					mismatch = true;
+				}
+			}
+		});
+	}
+
+	std::vector<std::thread> writers;
+	std::atomic<bool> wrong_insert{false};
+	for (int32_t w = 0; w < WRITERS; ++w)
+	{
+		writers.emplace_back([&, w] {
+			// every writer also inserts a key of the next one, only the first insertion counts
+			for (int32_t i = 0; i < PER_WRITER; ++i)
+			{
+				const int32_t key = w * PER_WRITER + i;
+				const int32_t other = ((w + 1) % WRITERS) * PER_WRITER + i;
+				if (map.insert(key, key) != key || map.insert(other, other) != other)
+				{
+					wrong_insert = true;
+				}
+			}
+		});
+	}
+	for (auto& writer : writers)
+	{
+		writer.join();
+	}
+	done = true;
+	for (auto& reader : readers)
+	{
+		reader.join();
+	}
+
+	bool ok = !mismatch && !wrong_insert;
+	for (int64_t key = 0; ok && key < PER_WRITER * WRITERS; ++key)
+	{
+		auto index = map.find(key);
+		ok = index && *index == key;
+	}
+	ok &= map.insert(0, 42) == 0;
+	map.assign(0, 42);
+	ok &= *map.find(0) == 42 && !map.find(-1);
+	return report("index_map_concurrent_inserts", ok);
+}
+}	 // namespace
+
+int main()
+{
+	bool ok = true;
+	ok &= segmented_array_concurrent_reads();
+	ok &= segmented_array_rejects_implausible_index();
+	ok &= index_map_concurrent_inserts();
+	std::cout << (ok ? "OK" : "FAILED") << std::endl;
+	return ok ? 0 : 1;
+}
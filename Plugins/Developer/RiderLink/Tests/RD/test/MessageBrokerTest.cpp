@@ -0,0 +1,312 @@
+#include "protocol/MessageBroker.h"
+#include "base/RdReactiveBase.h"
+#include "scheduler/SingleThreadScheduler.h"
+#include "lifetime/LifetimeDefinition.h"
+
+#include <atomic>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+/**
+ * \brief Scheduler whose actions are executed only by [pump], so that the order of tasks is under control of the test.
+ */
+class ManualScheduler : public IScheduler
+{
+	std::deque<std::function<void()>> actions;
+	bool active = false;
+
+public:
+	ManualScheduler()
+	{
+		thread_id = std::this_thread::get_id();
+	}
+
+	void queue(std::function<void()> action) override
+	{
+		actions.push_back(std::move(action));
+	}
+
+	void flush() override
+	{
+		pump();
+	}
+
+	bool is_active() const override
+	{
+		return active;
+	}
+
+	/**
+	 * \brief Executes [action] immediately as if it was queued.
+	 */
+	void run(std::function<void()> const& action)
+	{
+		active = true;
+		action();
+		active = false;
+	}
+
+	void pump()
+	{
+		active = true;
+		while (!actions.empty())
+		{
+			auto action = std::move(actions.front());
+			actions.pop_front();
+			action();
+		}
+		active = false;
+	}
+};
+
+/**
+ * \brief Entity recording the payloads received from the wire.
+ */
+class Recorder : public RdReactiveBase
+{
+	IScheduler* scheduler;
+
+public:
+	mutable std::mutex lock;
+	mutable std::vector<int32_t> received;
+
+	Recorder(RdId id, IScheduler* scheduler) : scheduler(scheduler)
+	{
+		set_id(id);
+	}
+
+	void set_wire_scheduler(IScheduler* value)
+	{
+		scheduler = value;
+	}
+
+	IScheduler* get_wire_scheduler() const override
+	{
+		return scheduler;
+	}
+
+	void on_wire_received(Buffer buffer) const override
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		received.push_back(buffer.read_integral<int32_t>());
+	}
+};
+
+Buffer message(int32_t value)
+{
+	Buffer buffer;
+	buffer.write_integral<int16_t>(0);	  // context
+	buffer.write_integral<int32_t>(value);
+	buffer.rewind();
+	return buffer;
+}
+
+// [received] must be the last messages of 0 until [count] in order, the ones handled before subscription are dropped
+bool check_order(std::string const& name, std::vector<int32_t> const& received, int32_t count)
+{
+	bool ok = !received.empty() && received.back() == count - 1;
+	for (size_t i = 1; ok && i < received.size(); ++i)
+	{
+		ok = received[i] == received[i - 1] + 1;
+	}
+	if (!ok)
+	{
+		std::cerr << name << ": received " << received.size() << " of " << count << " messages out of order" << std::endl;
+	}
+	return ok;
+}
+
+// message dispatched while the subscription is pending must not overtake its backlog via the batch of the default inbox
+bool subscribe_with_backlog()
+{
+	LifetimeDefinition definition(Lifetime::Eternal());
+	ManualScheduler scheduler;
+	MessageBroker broker(&scheduler);
+
+	Recorder other(RdId(1), &scheduler);
+	Recorder late(RdId(2), &scheduler);
+	scheduler.run([&] { broker.advise_on(definition.lifetime, &other); });
+
+	// batch of the default inbox is queued ahead of the backlog of [late]
+	broker.dispatch(other.get_id(), message(0));
+	broker.dispatch(late.get_id(), message(0));
+	broker.dispatch(late.get_id(), message(1));
+
+	scheduler.run([&] { broker.advise_on(definition.lifetime, &late); });
+	broker.dispatch(late.get_id(), message(2));
+	broker.dispatch(other.get_id(), message(1));
+
+	scheduler.pump();
+
+	broker.dispatch(late.get_id(), message(3));
+	scheduler.pump();
+
+	const bool ok = late.received.size() == 4 && check_order("subscribe_with_backlog", late.received, 4) &&
+					other.received.size() == 2 &&
+					check_order("subscribe_with_backlog (other)", other.received, 2);
+	definition.terminate();
+	return ok;
+}
+
+// messages dispatched from the wire thread while the entity subscribes on the default scheduler keep their order
+bool subscribe_during_concurrent_dispatch(int run)
+{
+	constexpr int32_t COUNT = 20000;
+
+	LifetimeDefinition definition(Lifetime::Eternal());
+	// scheduler names must be unique, they name loggers
+	SingleThreadScheduler scheduler(definition.lifetime, "MessageBrokerTest" + std::to_string(run));
+	MessageBroker broker(&scheduler);
+
+	Recorder other(RdId(1), &scheduler);
+	Recorder late(RdId(2), &scheduler);
+	scheduler.queue([&] { broker.advise_on(definition.lifetime, &other); });
+	scheduler.flush();
+
+	std::atomic<int32_t> sent{0};
+	std::thread wire([&] {
+		for (int32_t i = 0; i < COUNT; ++i)
+		{
+			// keeps the default inbox scheduled
+			broker.dispatch(other.get_id(), message(i));
+			broker.dispatch(late.get_id(), message(i));
+			sent = i + 1;
+		}
+	});
+
+	while (sent < COUNT / 4)
+	{
+		std::this_thread::yield();
+	}
+	scheduler.queue([&] { broker.advise_on(definition.lifetime, &late); });
+
+	wire.join();
+	scheduler.flush();
+	while (true)
+	{
+		{
+			std::lock_guard<std::mutex> guard(late.lock);
+			if (!late.received.empty() && late.received.back() == COUNT - 1)
+			{
+				break;
+			}
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		scheduler.flush();
+	}
+
+	bool ok;
+	{
+		std::lock_guard<std::mutex> late_guard(late.lock);
+		std::lock_guard<std::mutex> other_guard(other.lock);
+		ok = check_order("subscribe_during_concurrent_dispatch", late.received, COUNT) &&
+			 check_order("subscribe_during_concurrent_dispatch (other)", other.received, COUNT);
+	}
+	definition.terminate();
+	return ok;
+}
+
+// inbox of a destroyed scheduler must not be inherited by the next scheduler allocated at the same address
+bool reuse_scheduler_address()
+{
+	LifetimeDefinition definition(Lifetime::Eternal());
+	ManualScheduler default_scheduler;
+	MessageBroker broker(&default_scheduler);
+
+	alignas(ManualScheduler) unsigned char storage[sizeof(ManualScheduler)];
+	auto wire_scheduler = new (storage) ManualScheduler();
+	Recorder recorder(RdId(1), wire_scheduler);
+	default_scheduler.run([&] { broker.advise_on(definition.lifetime, &recorder); });
+
+	// the batch task is dropped together with the scheduler, its inbox stays scheduled and is never freed
+	broker.dispatch(recorder.get_id(), message(0));
+	wire_scheduler->~ManualScheduler();
+
+	wire_scheduler = new (storage) ManualScheduler();
+	recorder.set_wire_scheduler(wire_scheduler);
+	broker.dispatch(recorder.get_id(), message(1));
+	wire_scheduler->pump();
+
+	const bool ok = recorder.received == std::vector<int32_t>{1};
+	if (!ok)
+	{
+		std::cerr << "reuse_scheduler_address: received " << recorder.received.size() << " messages" << std::endl;
+	}
+	definition.terminate();
+	wire_scheduler->~ManualScheduler();
+	return ok;
+}
+
+// inboxes are released when their schedulers are no longer used, messages in flight are still delivered
+bool switch_schedulers()
+{
+	constexpr int32_t COUNT = 1000;
+
+	ManualScheduler default_scheduler;
+	MessageBroker broker(&default_scheduler);
+	Recorder recorder(RdId(1), nullptr);
+	std::vector<int32_t> expected;
+	{
+		LifetimeDefinition definition(Lifetime::Eternal());
+		for (int32_t i = 0; i < COUNT; ++i)
+		{
+			auto scheduler = std::make_unique<ManualScheduler>();
+			recorder.set_wire_scheduler(scheduler.get());
+			if (i == 0)
+			{
+				default_scheduler.run([&] { broker.advise_on(definition.lifetime, &recorder); });
+			}
+			broker.dispatch(recorder.get_id(), message(i));
+			if (i % 2 == 0)
+			{
+				// the batch outlives the subscription of its inbox
+				recorder.set_wire_scheduler(&default_scheduler);
+				broker.dispatch(recorder.get_id(), message(-1));
+			}
+			scheduler->pump();
+			expected.push_back(i);
+		}
+		default_scheduler.pump();
+		definition.terminate();
+	}
+
+	std::vector<int32_t> received;
+	for (int32_t value : recorder.received)
+	{
+		if (value >= 0)
+		{
+			received.push_back(value);
+		}
+	}
+	const bool ok = received == expected && recorder.received.size() == COUNT + COUNT / 2;
+	if (!ok)
+	{
+		std::cerr << "switch_schedulers: received " << recorder.received.size() << " messages" << std::endl;
+	}
+	return ok;
+}
+}	 // namespace
+
+int main()
+{
+	bool ok = true;
+	ok &= subscribe_with_backlog();
+	ok &= reuse_scheduler_address();
+	ok &= switch_schedulers();
+	for (int i = 0; i < 20; ++i)
+	{
+		ok &= subscribe_during_concurrent_dispatch(i);
+	}
+	std::cout << (ok ? "OK" : "FAILED") << std::endl;
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+#include "scheduler/WorkStealingScheduler.h"
+#include "lifetime/LifetimeDefinition.h"
+
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+// pool names must be unique, they name loggers
+std::string pool_name(std::string const& test, int run = 0)
+{
+	return "SerialSchedulerTest " + test + " " + std::to_string(run);
+}
+
+bool report(std::string const& name, bool ok)
+{
+	if (!ok)
+	{
+		std::cerr << name << " failed" << std::endl;
+	}
+	return ok;
+}
+
+// actions of a serial scheduler are executed one at a time in the order they were queued
+bool per_serial_ordering()
+{
+	constexpr size_t SERIALS = 8;
+	constexpr int32_t COUNT = 20000;
+
+	LifetimeDefinition definition(Lifetime::Eternal());
+	bool ok = true;
+	{
+		WorkStealingScheduler pool(definition.lifetime, pool_name("ordering"), 4);
+		std::vector<std::unique_ptr<SerialScheduler>> serials;
+		std::vector<std::vector<int32_t>> executed(SERIALS);
+		std::vector<std::atomic<int>> running(SERIALS);
+		std::atomic<bool> overlapped{false};
+		std::atomic<bool> inactive{false};
+		for (size_t i = 0; i < SERIALS; ++i)
+		{
+			serials.push_back(std::make_unique<SerialScheduler>(pool));
+		}
+
+		std::vector<std::thread> producers;
+		for (size_t i = 0; i < SERIALS; ++i)
+		{
+			producers.emplace_back([&, i] {
+				SerialScheduler& serial = *serials[i];
+				for (int32_t value = 0; value < COUNT; ++value)
+				{
+					serial.queue([&, i, value] {
+						if (running[i]++ != 0)
+						{
+							overlapped = true;
+						}
+						if (!serials[i]->is_active())
+						{
+							inactive = true;
+						}
+						executed[i].push_back(value);
+						--running[i];
+					});
+				}
+			});
+		}
+		for (auto& producer : producers)
+		{
+			producer.join();
+		}
+		for (auto& serial : serials)
+		{
+			serial->flush();
+		}
+
+		ok = !overlapped && !inactive;
+		for (auto const& values : executed)
+		{
+			ok &= values.size() == COUNT;
+			for (size_t j = 0; ok && j < values.size(); ++j)
+			{
+				ok = values[j] == static_cast<int32_t>(j);
+			}
+		}
+		serials.clear();
+		definition.terminate();
+	}
+	return report("per_serial_ordering", ok);
+}
+
+// flush() returns once the queued actions and the ones they queue are executed
+bool flush_waits_for_nested_actions()
+{
+	constexpr int DEPTH = 1000;
+
+	LifetimeDefinition definition(Lifetime::Eternal());
+	bool ok;
+	{
+		WorkStealingScheduler pool(definition.lifetime, pool_name("flush"), 2);
+		SerialScheduler serial(pool);
+		std::atomic<int> executed{0};
+		std::function<void()> action = [&] {
+			if (++executed < DEPTH)
+			{
+				serial.queue(action);
+			}
+		};
+		serial.queue(action);
+		serial.flush();
+		ok = executed == DEPTH;
+		definition.terminate();
+	}
+	return report("flush_waits_for_nested_actions", ok);
+}
+
+// the pool stopped by an action of the serial scheduler drops the actions queued afterwards, flush() doesn't hang
+bool stop_from_own_action()
+{
+	LifetimeDefinition definition(Lifetime::Eternal());
+	std::atomic<bool> stopped{false};
+	std::atomic<bool> dropped_executed{false};
+	bool ok;
+	{
+		WorkStealingScheduler pool(definition.lifetime, pool_name("stop"), 2);
+		SerialScheduler serial(pool);
+		serial.queue([&] {
+			definition.terminate();
+			stopped = pool.is_stopped();
+			serial.queue([&] { dropped_executed = true; });
+		});
+		serial.flush();
+		ok = stopped && !dropped_executed && !pool.try_queue([] {});
+	}
+	return report("stop_from_own_action", ok);
+}
+
+// serial scheduler destroyed while its pool is stopping waits for its batch, which must not run on a freed scheduler
+bool destroy_during_stop(int run)
+{
+	constexpr int COUNT = 1000;
+
+	LifetimeDefinition definition(Lifetime::Eternal());
+	std::atomic<int> executed{0};
+	{
+		WorkStealingScheduler pool(definition.lifetime, pool_name("destroy", run), 2);
+		auto serial = std::make_unique<SerialScheduler>(pool);
+		for (int i = 0; i < COUNT; ++i)
+		{
+			serial->queue([&] { ++executed; });
+		}
+		std::thread stopping([&] { definition.terminate(); });
+		serial.reset();
+		stopping.join();
+	}
+	return report("destroy_during_stop", executed <= COUNT);
+}
+}	 // namespace
+
+int main()
+{
+	bool ok = true;
+	ok &= per_serial_ordering();
+	ok &= flush_waits_for_nested_actions();
+	ok &= stop_from_own_action();
+	for (int i = 0; i < 20; ++i)
+	{
+		ok &= destroy_during_stop(i);
+	}
+	std::cout << (ok ? "OK" : "FAILED") << std::endl;
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,228 @@
+#include "protocol/Buffer.h"
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+bool ok = true;
+
+void check(bool condition, std::string const& message)
+{
+	if (!condition)
+	{
+		std::cerr << message << std::endl;
+		ok = false;
+	}
+}
+
+template <typename T>
+std::vector<T> samples()
+{
+	using limits = std::numeric_limits<T>;
+	std::vector<T> values{limits::min(), limits::max(), T(0), T(1), T(63), T(64), T(127)};
+	if (sizeof(T) > 1)
+	{
+		values.push_back(T(128));
+		values.push_back(T(300));
+		values.push_back(static_cast<T>(limits::max() - 1));
+		values.push_back(static_cast<T>(limits::min() + 1));
+	}
+	if (std::is_signed<T>::value)
+	{
+		values.push_back(T(-1));
+		values.push_back(T(-64));
+		values.push_back(T(-65));
+	}
+	return values;
+}
+
+// values of all widths read back in both modes, fixed width mode is byte to byte the format of write_integral
+template <typename T>
+void round_trip(std::string const& type)
+{
+	for (bool varint_integrals : {false, true})
+	{
+		for (T value : samples<T>())
+		{
+			const std::string name = type + (varint_integrals ? " varint " : " fixed ") + std::to_string(value);
+
+			Buffer buffer;
+			buffer.set_varint_integrals(varint_integrals);
+			buffer.write_varint(value);
+			buffer.write_integral<int32_t>(0x5A5A5A5A);	   // guard after the value
+			const size_t length = buffer.get_position() - sizeof(int32_t);
+			buffer.rewind();
+			check(buffer.read_varint<T>() == value, name + ": read another value");
+			check(buffer.read_integral<int32_t>() == 0x5A5A5A5A, name + ": read wrong length");
+
+			if (!varint_integrals || sizeof(T) == 1)
+			{
+				Buffer fixed;
+				fixed.write_integral(value);
+				fixed.write_integral<int32_t>(0x5A5A5A5A);
+				check(buffer.getRealArray() == fixed.getRealArray(), name + ": differs from write_integral");
+				continue;
+			}
+			check(length <= (8 * sizeof(T) + 6) / 7, name + ": too long varint, " + std::to_string(length));
+			const bool small = std::is_signed<T>::value ? (value >= -64 && value <= 63) : value <= 127;
+			check(small == (length == 1), name + ": unexpected length " + std::to_string(length));
+		}
+	}
+}
+
+Buffer::ByteArray bytes_of(std::vector<int> const& values)
+{
+	Buffer::ByteArray bytes;
+	for (int value : values)
+	{
+		bytes.push_back(static_cast<Buffer::word_t>(value));
+	}
+	return bytes;
+}
+
+template <typename T>
+Buffer::ByteArray varint_bytes(T value)
+{
+	Buffer buffer;
+	buffer.set_varint_integrals(true);
+	buffer.write_varint(value);
+	return std::move(buffer).getRealArray();
+}
+
+// LEB128 with zigzag for signed values, as other rd implementations read it
+void known_encodings()
+{
+	check(varint_bytes<int32_t>(0) == bytes_of({0x00}), "0");
+	check(varint_bytes<int32_t>(-1) == bytes_of({0x01}), "-1");
+	check(varint_bytes<int32_t>(1) == bytes_of({0x02}), "1");
+	check(varint_bytes<int32_t>(-64) == bytes_of({0x7F}), "-64");
+	check(varint_bytes<int32_t>(64) == bytes_of({0x80, 0x01}), "64");
+	check(varint_bytes<uint32_t>(300) == bytes_of({0xAC, 0x02}), "300u");
+	check(varint_bytes<int32_t>(std::numeric_limits<int32_t>::min()) == bytes_of({0xFF, 0xFF, 0xFF, 0xFF, 0x0F}), "int32 min");
+	check(varint_bytes<uint64_t>(std::numeric_limits<uint64_t>::max()) ==
+			  bytes_of({0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01}),
+		"uint64 max");
+}
+
+enum class Severity
+{
+	Info,
+	Warning,
+	Error
+};
+
+/**
+ * \brief Model shaped like the patched UE4Library ones (e.g. LogMessageInfo, ConnectionInfo): integral fields and
+ * enums go through read_varint/write_varint, the rest is written as before.
+ */
+struct LogMessage
+{
+	int32_t process_id;
+	int64_t timestamp;
+	Severity severity;
+	std::wstring text;
+	bool has_location;
+	uint16_t line;
+
+	static LogMessage read(Buffer& buffer)
+	{
+		auto process_id = buffer.read_varint<int32_t>();
+		auto timestamp = buffer.read_varint<int64_t>();
+		auto severity = buffer.read_enum<Severity>();
+		auto text = buffer.read_wstring();
+		auto has_location = buffer.read_bool();
+		auto line = buffer.read_varint<uint16_t>();
+		return LogMessage{process_id, timestamp, severity, std::move(text), has_location, line};
+	}
+
+	void write(Buffer& buffer) const
+	{
+		buffer.write_varint(process_id);
+		buffer.write_varint(timestamp);
+		buffer.write_enum(severity);
+		buffer.write_wstring(text);
+		buffer.write_bool(has_location);
+		buffer.write_varint(line);
+	}
+
+	// writer of the model before the patch, which peers unaware of varints read
+	void write_fixed(Buffer& buffer) const
+	{
+		buffer.write_integral(process_id);
+		buffer.write_integral(timestamp);
+		buffer.write_integral(static_cast<int32_t>(severity));
+		buffer.write_wstring(text);
+		buffer.write_bool(has_location);
+		buffer.write_integral(line);
+	}
+
+	bool operator==(LogMessage const& other) const
+	{
+		return process_id == other.process_id && timestamp == other.timestamp && severity == other.severity &&
+			   text == other.text && has_location == other.has_location && line == other.line;
+	}
+};
+
+void model_round_trip()
+{
+	const std::vector<LogMessage> messages{
+		{0, 0, Severity::Info, L"", false, 0},
+		{4242, 1600000000000LL, Severity::Warning, L"text \U0001F600", true, 65535},
+		{std::numeric_limits<int32_t>::min(), std::numeric_limits<int64_t>::max(), Severity::Error, L"x", true, 1},
+		{-1, -1, Severity::Info, std::wstring(300, L'a'), false, 128}};
+
+	for (bool varint_integrals : {false, true})
+	{
+		Buffer buffer;
+		buffer.set_varint_integrals(varint_integrals);
+		for (auto const& message : messages)
+		{
+			message.write(buffer);
+		}
+		const size_t length = buffer.get_position();
+		buffer.rewind();
+		for (auto const& message : messages)
+		{
+			check(LogMessage::read(buffer) == message,
+				std::string("model ") + (varint_integrals ? "varint" : "fixed") + ": read another message");
+		}
+		check(buffer.get_position() == length, "model: read wrong length");
+
+		Buffer fixed;
+		for (auto const& message : messages)
+		{
+			message.write_fixed(fixed);
+		}
+		if (varint_integrals)
+		{
+			check(length < fixed.get_position(), "model varint: not shorter than fixed width");
+		}
+		else
+		{
+			check(std::move(buffer).getRealArray() == std::move(fixed).getRealArray(), "model fixed: differs from the unpatched writer");
+		}
+	}
+}
+}	 // namespace
+
+int main()
+{
+	round_trip<int8_t>("int8");
+	round_trip<uint8_t>("uint8");
+	round_trip<int16_t>("int16");
+	round_trip<uint16_t>("uint16");
+	round_trip<int32_t>("int32");
+	round_trip<uint32_t>("uint32");
+	round_trip<int64_t>("int64");
+	round_trip<uint64_t>("uint64");
+	known_encodings();
+	model_round_trip();
+	std::cout << (ok ? "OK" : "FAILED") << std::endl;
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+#include "reactive/ViewableList.h"
+#include "reactive/ViewableMap.h"
+#include "lifetime/LifetimeDefinition.h"
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+bool check(std::string const& name, std::vector<std::string> const& actual, std::vector<std::string> const& expected)
+{
+	if (actual == expected)
+	{
+		return true;
+	}
+	std::cerr << name << ":";
+	for (auto const& s : actual)
+	{
+		std::cerr << " [" << s << "]";
+	}
+	std::cerr << std::endl;
+	return false;
+}
+
+std::vector<int> elements(ViewableList<int> const& list)
+{
+	std::vector<int> result;
+	for (size_t i = 0; i < list.size(); ++i)
+	{
+		result.push_back(list.get(i));
+	}
+	return result;
+}
+
+// per element handlers of bulk operations see the resulting list, the events still apply in order
+bool list_per_element_events()
+{
+	LifetimeDefinition definition(Lifetime::Eternal());
+	ViewableList<int> list;
+	list.addAll({1, 2, 3});
+
+	std::vector<std::string> log;
+	std::vector<int> mirror;
+	list.advise(definition.lifetime, [&](ViewableList<int>::Event const& e) {
+		log.push_back(to_string(e) + " size=" + std::to_string(list.size()));
+		if (auto value = e.get_new_value())
+		{
+			mirror.insert(mirror.begin() + e.get_index(), *value);
+		}
+		else
+		{
+			mirror.erase(mirror.begin() + e.get_index());
+		}
+	});
+	bool ok = check("list advise", log, {"Add 0:1 size=3", "Add 1:2 size=3", "Add 2:3 size=3"});
+
+	log.clear();
+	list.addAll(1, {10, 11});
+	ok &= check("list addAll", log, {"Add 1:10 size=5", "Add 2:11 size=5"});
+	ok &= mirror == elements(list);
+
+	log.clear();
+	list.removeAll({10, 3});
+	// indices of the list before removal, from the last one
+	ok &= check("list removeAll", log, {"Remove 4 size=3", "Remove 1 size=3"});
+	ok &= mirror == elements(list) && mirror == std::vector<int>{1, 11, 2};
+
+	log.clear();
+	list.clear();
+	ok &= check("list clear", log, {"Remove 2 size=3", "Remove 1 size=3", "Remove 0 size=3"});
+	ok &= mirror.empty() && list.empty();
+
+	definition.terminate();
+	return ok;
+}
+
+// a batch handler is called once per operation with all of its events
+bool list_batches()
+{
+	LifetimeDefinition definition(Lifetime::Eternal());
+	ViewableList<int> list;
+	list.add(1);
+
+	std::vector<std::string> log;
+	list.advise_batch(definition.lifetime, [&](ViewableList<int>::Batch const& batch) {
+		std::string events;
+		for (auto const& e : batch)
+		{
+			events += "[" + to_string(e) + "]";
+		}
+		log.push_back(events);
+	});
+	list.addAll({2, 3});
+	list.removeAll({1, 3});
+	list.add(4);
+	list.clear();
+	return check("list batches", log, {"[Add 0:1]", "[Add 1:2][Add 2:3]", "[Remove 2][Remove 0]", "[Add 1:4]", "[Remove 1][Remove 0]"});
+}
+
+// per entry handlers of setAll see the resulting map
+bool map_per_entry_events()
+{
+	LifetimeDefinition definition(Lifetime::Eternal());
+	ViewableMap<int, int> map;
+	map.set(1, 1);
+	map.set(2, 2);
+
+	std::vector<std::string> log;
+	std::map<int, int> mirror;
+	map.advise(definition.lifetime, [&](ViewableMap<int, int>::Event const& e) {
+		log.push_back(to_string(e) + " size=" + std::to_string(map.size()));
+		if (auto value = e.get_new_value())
+		{
+			mirror[*e.get_key()] = *value;
+		}
+		else
+		{
+			mirror.erase(*e.get_key());
+		}
+	});
+
+	log.clear();
+	map.setAll({{1, 10}, {2, 2}, {3, 3}});
+	// unchanged values aren't reported
+	bool ok = check("map setAll", log, {"Update 1:10 size=3", "Add 3:3 size=3"});
+	ok &= mirror == std::map<int, int>{{1, 10}, {2, 2}, {3, 3}};
+
+	log.clear();
+	map.clear();
+	ok &= check("map clear", log, {"Remove 1 size=3", "Remove 2 size=3", "Remove 3 size=3"});
+	ok &= mirror.empty() && map.empty();
+
+	definition.terminate();
+	return ok;
+}
+}	 // namespace
+
+int main()
+{
+	bool ok = true;
+	ok &= list_per_element_events();
+	ok &= list_batches();
+	ok &= map_per_entry_events();
+	std::cout << (ok ? "OK" : "FAILED") << std::endl;
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+#include "protocol/Buffer.h"
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace rd;
+
+namespace
+{
+using Units = std::vector<uint16_t>;
+
+// UTF-16 as on the wire, surrogate code points are kept as single units
+Units to_utf16(std::vector<uint32_t> const& code_points)
+{
+	Units units;
+	for (uint32_t c : code_points)
+	{
+		if (c > 0xFFFFu)
+		{
+			units.push_back(static_cast<uint16_t>(0xD800u + ((c - 0x10000u) >> 10)));
+			units.push_back(static_cast<uint16_t>(0xDC00u + ((c - 0x10000u) & 0x3FFu)));
+		}
+		else
+		{
+			units.push_back(static_cast<uint16_t>(c));
+		}
+	}
+	return units;
+}
+
+std::wstring to_wstring(std::vector<uint32_t> const& code_points)
+{
+	std::wstring result;
+	if (sizeof(wchar_t) == 2)
+	{
+		for (uint16_t unit : to_utf16(code_points))
+		{
+			result.push_back(static_cast<wchar_t>(unit));
+		}
+	}
+	else
+	{
+		for (uint32_t c : code_points)
+		{
+			result.push_back(static_cast<wchar_t>(c));
+		}
+	}
+	return result;
+}
+
+Units written_units(std::wstring const& value)
+{
+	Buffer buffer;
+	buffer.write_wstring(value);
+	buffer.rewind();
+	return buffer.read_array<std::vector, uint16_t>();
+}
+
+std::wstring read_units(Units const& units)
+{
+	Buffer buffer;
+	buffer.write_array<std::vector, uint16_t>(units);
+	buffer.rewind();
+	return buffer.read_wstring();
+}
+
+// [value] is written as UTF-16 [units] and read back unchanged, also after other data in the same buffer
+bool round_trip(std::string const& name, std::vector<uint32_t> const& code_points)
+{
+	const std::wstring value = to_wstring(code_points);
+	const Units units = to_utf16(code_points);
+
+	bool ok = written_units(value) == units && read_units(units) == value;
+
+	Buffer buffer;
+	buffer.write_integral<int8_t>(1);
+	buffer.write_wstring(value);
+	buffer.write_wstring(value);
+	buffer.write_integral<int32_t>(42);
+	buffer.rewind();
+	ok &= buffer.read_integral<int8_t>() == 1 && buffer.read_wstring() == value && buffer.read_wstring() == value &&
+		  buffer.read_integral<int32_t>() == 42;
+
+	if (!ok)
+	{
+		std::cerr << "round_trip " << name << " failed" << std::endl;
+	}
+	return ok;
+}
+
+bool bmp_text()
+{
+	bool ok = true;
+	ok &= round_trip("empty", {});
+	ok &= round_trip("ascii", {'R', 'i', 'd', 'e', 'r', ' ', '1', '\n', 0x7F, 0});
+	// Cyrillic, CJK, the last code points before and after the surrogates, U+FFFF
+	ok &= round_trip("bmp", {0x41F, 0x440, 0x438, 0x432, 0x435, 0x442, 0x4E16, 0x754C, 0xD7FF, 0xE000, 0xFFFD, 0xFFFF});
+	return ok;
+}
+
+bool supplementary_code_points()
+{
+	bool ok = true;
+	ok &= round_trip("first and last", {0x10000, 0x10FFFF});
+	ok &= round_trip("emoji in text", {'a', 0x1F600, 'b', 0x1F680, 0x1F680, 0x4E16, 0x20000});
+	ok &= round_trip("pair at end", {'x', 0x1F600});
+	return ok;
+}
+
+// unpaired surrogates, e.g. from a truncated Java or C# string, pass through unchanged
+bool unpaired_surrogates()
+{
+	bool ok = true;
+	ok &= round_trip("lone high", {0xD800});
+	ok &= round_trip("lone low", {0xDFFF});
+	ok &= round_trip("high at end", {'a', 0xDBFF});
+	ok &= round_trip("low before high", {0xDC00, 0xD800, 'a'});
+	ok &= round_trip("high before pair", {0xD83D, 0x1F600});
+	ok &= round_trip("pair before low", {0x1F600, 0xDE00});
+
+	if (sizeof(wchar_t) == 4)
+	{
+		// adjacent surrogate code points form a pair on the wire, they are read back as the code point it encodes
+		ok &= read_units(written_units(std::wstring{wchar_t(0xD83D), wchar_t(0xDE00)})) == std::wstring{wchar_t(0x1F600)};
+		// beyond Unicode, replaced by U+FFFD
+		const bool replaced = written_units(std::wstring{wchar_t(0x110000), 'a'}) == Units{0xFFFD, 'a'} &&
+							  written_units(std::wstring{wchar_t(0x110000), wchar_t(0x1F600)}) == Units{0xFFFD, 0xD83D, 0xDE00};
+		if (!replaced)
+		{
+			std::cerr << "code points beyond Unicode aren't replaced" << std::endl;
+		}
+		ok &= replaced;
+	}
+	return ok;
+}
+}	 // namespace
+
+int main()
+{
+	bool ok = true;
+	ok &= bmp_text();
+	ok &= supplementary_code_points();
+	ok &= unpaired_surrogates();
+	std::cout << (ok ? "OK" : "FAILED") << std::endl;
+	return ok ? 0 : 1;
+}